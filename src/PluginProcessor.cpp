@@ -7,6 +7,8 @@ OpenGuitarAudioProcessor::OpenGuitarAudioProcessor()
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       parameters(*this, nullptr, juce::Identifier("OpenGuitar"), createParameterLayout())
 {
+    // Rebuilt oversampling can change the latency; the fuzz reports it on the message thread
+    fuzzEffect.onLatencyChange = [this](int samples) { setLatencySamples(samples); };
 }
 
 OpenGuitarAudioProcessor::~OpenGuitarAudioProcessor()
@@ -30,6 +32,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout OpenGuitarAudioProcessor::cr
         "level", "Level", 
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f));
     
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling", "Oversampling",
+        juce::StringArray { "Off", "2x", "4x", "8x", "16x" }, 1));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversamplingFilter", "Oversampling Filter",
+        juce::StringArray { "IIR", "Linear Phase", "Minimum Phase" }, 0));
+
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         "bypass", "Bypass", false));
 
@@ -38,12 +48,19 @@ juce::AudioProcessorValueTreeState::ParameterLayout OpenGuitarAudioProcessor::cr
 
 void OpenGuitarAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    fuzzEffect.setNumChannels(getTotalNumOutputChannels());
+    updateFuzzOversampling();
     fuzzEffect.prepare(sampleRate, samplesPerBlock);
+    setLatencySamples(fuzzEffect.getLatencySamples());
+
+    bypassDelay.prepare(getTotalNumOutputChannels(), maxBypassDelay);
+    bypassDelay.setDelay(fuzzEffect.getLatencySamples());
 }
 
 void OpenGuitarAudioProcessor::releaseResources()
 {
     fuzzEffect.reset();
+    bypassDelay.reset();
 }
 
 bool OpenGuitarAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -67,15 +84,49 @@ void OpenGuitarAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    // Passed on while bypassed too, so a new oversampling is already built when the fuzz comes back
+    updateFuzzOversampling();
+
     bool bypass = parameters.getRawParameterValue("bypass")->load() > 0.5f;
     
-    if (!bypass)
+    if (bypass)
     {
-        fuzzEffect.setGain(parameters.getRawParameterValue("gain")->load());
-        fuzzEffect.setTone(parameters.getRawParameterValue("tone")->load());
-        fuzzEffect.setLevel(parameters.getRawParameterValue("level")->load());
-        fuzzEffect.processBlock(buffer);
+        processBypassed(buffer);
+        return;
     }
+
+    fuzzEffect.setGain(parameters.getRawParameterValue("gain")->load());
+    fuzzEffect.setTone(parameters.getRawParameterValue("tone")->load());
+    fuzzEffect.setLevel(parameters.getRawParameterValue("level")->load());
+
+    // Keep the bypass delay's history current so a switch to bypass lines up straight away
+    bypassDelay.setDelay(fuzzEffect.getLatencySamples());
+    bypassDelay.write(juce::dsp::AudioBlock<float>(buffer));
+    fuzzEffect.processBlock(buffer);
+}
+
+void OpenGuitarAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+        buffer.clear(i, 0, buffer.getNumSamples());
+
+    processBypassed(buffer);
+}
+
+void OpenGuitarAudioProcessor::processBypassed(juce::AudioBuffer<float>& buffer)
+{
+    // The host is told about the fuzz's latency whether it is bypassed or not
+    bypassDelay.setDelay(fuzzEffect.getLatencySamples());
+    bypassDelay.process(juce::dsp::AudioBlock<float>(buffer));
+}
+
+void OpenGuitarAudioProcessor::updateFuzzOversampling()
+{
+    fuzzEffect.setOversampling(juce::roundToInt(parameters.getRawParameterValue("oversampling")->load()));
+    fuzzEffect.setOversamplingFilter(static_cast<Fuzz::OversamplingFilter>(
+        juce::roundToInt(parameters.getRawParameterValue("oversamplingFilter")->load())));
 }
 
 juce::AudioProcessorEditor* OpenGuitarAudioProcessor::createEditor()
@@ -3,6 +3,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "effects/Fuzz.h"
+#include "dsp/DelayCompensator.h"
 
 class OpenGuitarAudioProcessor : public juce::AudioProcessor
 {
@@ -14,6 +15,8 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    juce::AudioProcessorParameter* getBypassParameter() const override { return parameters.getParameter("bypass"); }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -42,5 +45,14 @@ public:
 private:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
+    // Passes the oversampling choices to the fuzz (real-time safe)
+    void updateFuzzOversampling();
+
+    // Passes the input through, delayed by the fuzz's latency so the track stays aligned
+    void processBypassed(juce::AudioBuffer<float>& buffer);
+
+    DelayCompensator bypassDelay;
+    static constexpr int maxBypassDelay = 2048;   // Longest oversampling latency the bypass is compensated for
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OpenGuitarAudioProcessor)
 };
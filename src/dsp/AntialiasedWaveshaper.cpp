@@ -0,0 +1,147 @@
+#include "AntialiasedWaveshaper.h"
+#include <cmath>
+
+namespace
+{
+    // Below these input differences the quotients lose too much precision and
+    // the midpoint fallback is used. The second order divides twice, so needs more room.
+    constexpr double firstOrderTolerance = 1.0e-5;
+    constexpr double secondOrderTolerance = 1.0e-4;
+}
+
+AntialiasedWaveshaper::AntialiasedWaveshaper()
+{
+    setNumChannels(2);
+}
+
+AntialiasedWaveshaper::~AntialiasedWaveshaper()
+{
+}
+
+void AntialiasedWaveshaper::setShaper(const Waveshaper& newShaper)
+{
+    jassert(newShaper.isBuilt());
+    shaper = &newShaper;
+    reset();
+}
+
+void AntialiasedWaveshaper::setOrder(Order newOrder)
+{
+    if (newOrder != order)
+    {
+        order = newOrder;
+        reset();
+    }
+}
+
+void AntialiasedWaveshaper::setNumChannels(int newNumChannels)
+{
+    state.assign(static_cast<size_t>(juce::jmax(1, newNumChannels)), ChannelState {});
+}
+
+void AntialiasedWaveshaper::reset()
+{
+    // Both antiderivatives are zero at x = 0, so a zeroed history is a silent one
+    std::fill(state.begin(), state.end(), ChannelState {});
+}
+
+float AntialiasedWaveshaper::processSample(float sample, int channel) noexcept
+{
+    jassert(shaper != nullptr && channel >= 0 && channel < getNumChannels());
+    auto& channelState = state[static_cast<size_t>(channel)];
+
+    switch (order)
+    {
+        case Order::First:  return processFirstOrder(sample, channelState);
+        case Order::Second: return processSecondOrder(sample, channelState);
+        case Order::None:   break;
+    }
+
+    return shaper->processSample(sample);
+}
+
+void AntialiasedWaveshaper::processBlock(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    jassert(shaper != nullptr);
+
+    const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer(static_cast<size_t>(channel));
+        auto& channelState = state[static_cast<size_t>(channel)];
+
+        if (order == Order::None)
+        {
+            shaper->process(data, numSamples);
+        }
+        else if (order == Order::First)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = processFirstOrder(data[i], channelState);
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = processSecondOrder(data[i], channelState);
+        }
+    }
+}
+
+float AntialiasedWaveshaper::processFirstOrder(double x, ChannelState& channel) const noexcept
+{
+    const double antiderivative = shaper->getAntiderivative(x);
+    const double step = x - channel.x1;
+
+    // (F1(x) - F1(x1)) / (x - x1): the curve's mean between the two inputs
+    const double output = std::abs(step) > firstOrderTolerance
+                            ? (antiderivative - channel.antiderivative) / step
+                            : static_cast<double>(shaper->processSample(static_cast<float>(0.5 * (x + channel.x1))));
+
+    channel.x1 = x;
+    channel.antiderivative = antiderivative;
+
+    return static_cast<float>(output);
+}
+
+float AntialiasedWaveshaper::processSecondOrder(double x, ChannelState& channel) const noexcept
+{
+    // First-order average of F1 between x1 and x, from the second antiderivative
+    const double antiderivative = shaper->getSecondAntiderivative(x);
+    const double step = x - channel.x1;
+    const double difference = std::abs(step) > secondOrderTolerance
+                                ? (antiderivative - channel.antiderivative) / step
+                                : shaper->getAntiderivative(0.5 * (x + channel.x1));
+
+    double output;
+    const double span = x - channel.x2;
+
+    if (std::abs(span) > secondOrderTolerance)
+    {
+        output = 2.0 * (difference - channel.previousDifference) / span;
+    }
+    else
+    {
+        // x2 and x nearly coincide: expand around their midpoint instead
+        const double midpoint = 0.5 * (x + channel.x2);
+        const double offset = midpoint - channel.x1;
+
+        if (std::abs(offset) > secondOrderTolerance)
+        {
+            output = 2.0 / offset * (shaper->getAntiderivative(midpoint)
+                                     + (channel.antiderivative - shaper->getSecondAntiderivative(midpoint)) / offset);
+        }
+        else
+        {
+            output = static_cast<double>(shaper->processSample(static_cast<float>(0.5 * (midpoint + channel.x1))));
+        }
+    }
+
+    channel.x2 = channel.x1;
+    channel.x1 = x;
+    channel.antiderivative = antiderivative;
+    channel.previousDifference = difference;
+
+    return static_cast<float>(output);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "Waveshaper.h"
+#include <vector>
+
+/**
+ * Antiderivative anti-aliasing (ADAA) around a Waveshaper curve.
+ *
+ * Instead of the curve's value at each sample, outputs the curve's average
+ * between consecutive samples, computed from the difference of its
+ * antiderivative. That averaging is a lowpass applied before the nonlinearity
+ * samples the signal, so far less of the distortion above Nyquist folds back,
+ * at the base sample rate and a few operations per sample.
+ *
+ * Order::None passes straight through to the Waveshaper, so a pedal can
+ * route its clipping through this class whatever its quality setting.
+ * First order averages over one sample step and delays by half a sample.
+ * Second order averages the first-order result again using the second
+ * antiderivative. It suppresses aliasing further and delays by one sample.
+ * Both also darken the very top octave slightly. Where consecutive inputs
+ * are too close for the difference quotient to be accurate, the curve is
+ * evaluated at their midpoint instead.
+ *
+ * The state per channel is sized by setNumChannels(), which allocates and
+ * belongs in prepare code. The Waveshaper must outlive this object.
+ */
+class AntialiasedWaveshaper
+{
+public:
+    enum class Order
+    {
+        None = 0,
+        First = 1,
+        Second = 2
+    };
+
+    AntialiasedWaveshaper();
+    ~AntialiasedWaveshaper();
+
+    /** Sets the curve to shape with. The waveshaper must already be built. */
+    void setShaper(const Waveshaper& newShaper);
+    void setOrder(Order newOrder);
+    void setNumChannels(int newNumChannels);
+
+    /** Clears the input history. */
+    void reset();
+
+    float processSample(float sample, int channel) noexcept;
+
+    /** Shapes a block in place. Channels past getNumChannels() are left untouched. */
+    void processBlock(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    Order getOrder() const noexcept { return order; }
+    int getNumChannels() const noexcept { return static_cast<int>(state.size()); }
+
+private:
+    /** The input history of one channel, with the antiderivative values already computed for it. */
+    struct ChannelState
+    {
+        double x1 = 0.0;                   // Previous input
+        double x2 = 0.0;                   // Input before that
+        double antiderivative = 0.0;       // F1(x1) for first order, F2(x1) for second
+        double previousDifference = 0.0;   // Second order: the average of F1 from x2 to x1
+    };
+
+    float processFirstOrder(double x, ChannelState& channel) const noexcept;
+    float processSecondOrder(double x, ChannelState& channel) const noexcept;
+
+    const Waveshaper* shaper = nullptr;
+    Order order = Order::Second;
+    std::vector<ChannelState> state;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AntialiasedWaveshaper)
+};
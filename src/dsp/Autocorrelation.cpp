@@ -0,0 +1,58 @@
+#include "Autocorrelation.h"
+#include <algorithm>
+
+FFTAutocorrelation::FFTAutocorrelation()
+{
+}
+
+FFTAutocorrelation::~FFTAutocorrelation()
+{
+}
+
+void FFTAutocorrelation::prepare(int newMaxNumSamples)
+{
+    maxNumSamples = juce::jmax(1, newMaxNumSamples);
+
+    // Zero-padding to at least 2N keeps the circular correlation from wrapping
+    const int order = juce::roundToInt(std::ceil(std::log2(2.0 * maxNumSamples)));
+    fft = std::make_unique<juce::dsp::FFT>(order);
+    fftSize = 1 << order;
+
+    fftBuffer.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+    energy.assign(static_cast<size_t>(maxNumSamples + 1), 0.0f);
+    numSamples = 0;
+}
+
+void FFTAutocorrelation::process(const float* samples, int newNumSamples)
+{
+    processSpectrum(samples, newNumSamples);
+
+    // Inverse transform (scaled by 1 / fftSize) gives the raw autocorrelation per lag
+    fft->performRealOnlyInverseTransform(fftBuffer.data());
+
+    // Running energy, so any range of the frame can be normalised in O(1)
+    energy[0] = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+        energy[static_cast<size_t>(i + 1)] = energy[static_cast<size_t>(i)] + samples[i] * samples[i];
+}
+
+void FFTAutocorrelation::processSpectrum(const float* samples, int newNumSamples)
+{
+    jassert(fft != nullptr && newNumSamples <= maxNumSamples);
+    numSamples = juce::jmin(newNumSamples, maxNumSamples);
+
+    // Zero-padded frame
+    std::copy(samples, samples + numSamples, fftBuffer.begin());
+    std::fill(fftBuffer.begin() + numSamples, fftBuffer.end(), 0.0f);
+
+    fft->performRealOnlyForwardTransform(fftBuffer.data());
+
+    // Power spectrum: |X(k)|^2 in the real part, zero imaginary part
+    for (int bin = 0; bin < fftSize; ++bin)
+    {
+        const float re = fftBuffer[static_cast<size_t>(2 * bin)];
+        const float im = fftBuffer[static_cast<size_t>(2 * bin + 1)];
+        fftBuffer[static_cast<size_t>(2 * bin)] = re * re + im * im;
+        fftBuffer[static_cast<size_t>(2 * bin + 1)] = 0.0f;
+    }
+}
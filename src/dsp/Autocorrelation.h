@@ -0,0 +1,79 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+/**
+ * Autocorrelation of a whole frame in O(N log N).
+ *
+ * Uses the Wiener-Khinchin theorem: the frame is zero-padded to twice its
+ * length, transformed, replaced by its power spectrum and transformed back,
+ * which yields the linear (not circular) autocorrelation
+ * r(lag) = sum(x[i] * x[i + lag]) for every lag at once.
+ *
+ * A running sum of x^2 is kept alongside, so the energy of any range of the
+ * frame is available in O(1). That is all the normalisations used by pitch
+ * detectors (plain, YIN difference function, McLeod NSDF) need.
+ *
+ * The power spectrum computed on the way can also be used on its own through
+ * processSpectrum(), so spectral analysis shares the same plan and buffers.
+ *
+ * All buffers are allocated in prepare(); process() never allocates.
+ */
+class FFTAutocorrelation
+{
+public:
+    FFTAutocorrelation();
+    ~FFTAutocorrelation();
+
+    /** Allocates the FFT plan and work buffers for frames up to maxNumSamples long. */
+    void prepare(int maxNumSamples);
+
+    /**
+     * Computes the autocorrelation and running energy of a frame.
+     * @param samples The frame to analyse
+     * @param numSamples Frame length, at most the size given to prepare()
+     */
+    void process(const float* samples, int numSamples);
+
+    /** r(lag) for lags 0 to getNumSamples() - 1, valid until the next call to process(). */
+    const float* getCorrelation() const { return fftBuffer.data(); }
+
+    /**
+     * Computes only the power spectrum |X(k)|^2 of a zero-padded frame.
+     * Afterwards getPower() is valid until the next call to process() or processSpectrum().
+     * @param samples The frame to analyse (already windowed if required)
+     * @param numSamples Frame length, at most the size given to prepare()
+     */
+    void processSpectrum(const float* samples, int numSamples);
+
+    /** Power of an FFT bin (0 to getFFTSize() / 2) after processSpectrum(). */
+    float getPower(int bin) const { return fftBuffer[static_cast<size_t>(2 * bin)]; }
+
+    /** Transform length, including the zero padding. */
+    int getFFTSize() const { return fftSize; }
+
+    /** Sum of x^2 over samples [start, end) of the last processed frame. */
+    float getEnergy(int start, int end) const
+    {
+        return energy[static_cast<size_t>(end)] - energy[static_cast<size_t>(start)];
+    }
+
+    /** Length of the last processed frame. */
+    int getNumSamples() const { return numSamples; }
+
+    int getMaxNumSamples() const { return maxNumSamples; }
+
+private:
+    std::unique_ptr<juce::dsp::FFT> fft;
+    int fftSize = 0;
+    int maxNumSamples = 0;
+    int numSamples = 0;
+
+    std::vector<float> fftBuffer;        // 2 * fftSize, as required by the real-only transforms
+    std::vector<float> energy;           // Running sum of x^2, energy[k] = sum of the first k squares
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FFTAutocorrelation)
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+/**
+ * Filter coefficients sampled across a control's 0 to 1 range.
+ *
+ * build() evaluates an expensive coefficient function (trig, exp, ...) at
+ * evenly spaced control values, once, when the sample rate is known. After
+ * that, lookup() returns coefficients for any control value by linear
+ * interpolation between the two nearest entries, so sweeps and smoothing
+ * cost a couple of multiply-adds per coefficient instead of the original
+ * math. Neighbouring entries are close enough that interpolated
+ * coefficients stay well behaved for smooth coefficient functions.
+ *
+ * build() allocates and belongs in prepare code. lookup() is real-time safe.
+ */
+template <size_t numValues>
+class CoefficientTable
+{
+public:
+    using Entry = std::array<float, numValues>;
+
+    /**
+     * Samples a coefficient function at numEntries evenly spaced control values.
+     * @param numEntries Number of table entries, at least 2
+     * @param function Maps a control value in [0, 1] to its coefficients
+     */
+    template <typename Function>
+    void build(int numEntries, Function&& function)
+    {
+        jassert(numEntries >= 2);
+        size = juce::jmax(2, numEntries);
+        entries.resize(static_cast<size_t>(size));
+
+        for (int i = 0; i < size; ++i)
+            entries[static_cast<size_t>(i)] = function(static_cast<float>(i) / static_cast<float>(size - 1));
+    }
+
+    /** Returns interpolated coefficients for a control value, clamped to [0, 1]. */
+    Entry lookup(float control) const noexcept
+    {
+        jassert(isBuilt());
+
+        const float position = juce::jlimit(0.0f, 1.0f, control) * static_cast<float>(size - 1);
+        const int index = juce::jmin(static_cast<int>(position), size - 2);
+        const float fraction = position - static_cast<float>(index);
+
+        const auto& lower = entries[static_cast<size_t>(index)];
+        const auto& upper = entries[static_cast<size_t>(index + 1)];
+
+        Entry result;
+        for (size_t i = 0; i < numValues; ++i)
+            result[i] = lower[i] + fraction * (upper[i] - lower[i]);
+
+        return result;
+    }
+
+    bool isBuilt() const noexcept { return !entries.empty(); }
+
+private:
+    std::vector<Entry> entries;
+    int size = 0;
+};
@@ -0,0 +1,71 @@
+#include "DelayCompensator.h"
+
+DelayCompensator::DelayCompensator()
+{
+}
+
+DelayCompensator::~DelayCompensator()
+{
+}
+
+void DelayCompensator::prepare(int numChannels, int maximumDelay)
+{
+    buffer.setSize(juce::jmax(1, numChannels), juce::jmax(0, maximumDelay) + 1);
+    setDelay(delay);
+    reset();
+}
+
+void DelayCompensator::reset()
+{
+    buffer.clear();
+    writePosition = 0;
+}
+
+void DelayCompensator::setDelay(int newDelay) noexcept
+{
+    delay = juce::jlimit(0, getMaximumDelay(), newDelay);
+}
+
+void DelayCompensator::process(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    run(block, true);
+}
+
+void DelayCompensator::write(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    run(block, false);
+}
+
+void DelayCompensator::run(const juce::dsp::AudioBlock<float>& block, bool delayBlock) noexcept
+{
+    const int length = buffer.getNumSamples();
+    const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), buffer.getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer(static_cast<size_t>(channel));
+        auto* ring = buffer.getWritePointer(channel);
+        int write = writePosition;
+        int read = write - delay;
+
+        if (read < 0)
+            read += length;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            ring[write] = data[i];
+
+            if (delayBlock)
+                data[i] = ring[read];
+
+            if (++write == length)
+                write = 0;
+
+            if (++read == length)
+                read = 0;
+        }
+    }
+
+    writePosition = (writePosition + numSamples) % length;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * Whole-sample delay that lines a signal up with a path that has latency.
+ *
+ * Typical uses are the dry signal of an effect with a mix control, which has
+ * to match the delay of its oversampled wet path, and a bypassed effect's
+ * signal, which has to arrive as late as the effect's output would have.
+ *
+ * write() records the signal without delaying it. Feeding the delay while
+ * the latent path is in use means the history is already there when
+ * process() takes over, so switching between the paths stays aligned.
+ *
+ * prepare() allocates and belongs in prepare code. Everything else is
+ * real-time safe. Delays beyond the prepared maximum are clamped.
+ */
+class DelayCompensator
+{
+public:
+    DelayCompensator();
+    ~DelayCompensator();
+
+    /**
+     * Sizes the delay line.
+     * @param numChannels The number of channels to delay
+     * @param maximumDelay The longest delay, in samples
+     */
+    void prepare(int numChannels, int maximumDelay);
+
+    /** Clears the delay line. */
+    void reset();
+
+    /** Sets the delay in samples, clamped to the prepared maximum. */
+    void setDelay(int newDelay) noexcept;
+
+    int getDelay() const noexcept { return delay; }
+    int getMaximumDelay() const noexcept { return buffer.getNumSamples() - 1; }
+
+    /** Delays a block in place. Channels past the prepared count are left untouched. */
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Records a block into the delay line without changing it. */
+    void write(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    // Writes (and optionally reads back delayed) one block, then advances the write position
+    void run(const juce::dsp::AudioBlock<float>& block, bool delayBlock) noexcept;
+
+    juce::AudioBuffer<float> buffer;   // One ring per channel, maximum delay + 1 long
+    int delay = 0;
+    int writePosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayCompensator)
+};
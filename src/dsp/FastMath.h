@@ -0,0 +1,126 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Fast float approximations of the transcendental functions used in the
+ * per-sample loops of the effects: exp, log, tanh and the dB conversions.
+ *
+ * Every function is inline, branch-free (clamps compile to min/max) and free
+ * of libm calls, so loops that call them auto-vectorize. (GCC only turns the
+ * clamps into min/max with -fno-trapping-math; Clang and MSVC do by default.)
+ * The error bounds below are against double precision libm on a dense sweep,
+ * and tests/FastMathTests.cpp checks them. Where a bound grows with the
+ * argument, that is the float rounding of the scaled argument itself, which
+ * libm float functions share:
+ *
+ *   exp2             relative error < 2.5e-7                  (input clamped to [-126, 126])
+ *   exp              relative error < 2.5e-7 * max(1, |x|)    (|x| < 87)
+ *   log2, log        absolute error < 1.7e-7 * max(1, |result|)  (positive normal floats)
+ *   tanh             absolute error < 1.5e-7                  (all finite inputs)
+ *   decibelsToGain   relative error < 2.7e-7 * max(1, |dB| / 10)
+ *   gainToDecibels   absolute error < 3e-7 * max(1, |dB|)
+ *
+ * Inputs outside the ranges (NaN, infinities, zero or negative log arguments)
+ * give unspecified but finite-or-NaN results rather than trapping, so callers
+ * clamp or floor where that matters, as they would with libm.
+ */
+namespace FastMath
+{
+    namespace detail
+    {
+        inline float bitsToFloat(std::int32_t bits) noexcept
+        {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        inline std::int32_t floatToBits(float value) noexcept
+        {
+            std::int32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        // Written as min/max selects, which compile to vector min/max instructions
+        inline float clamp(float x, float lower, float upper) noexcept
+        {
+            return std::min(upper, std::max(lower, x));
+        }
+    }
+
+    /** 2 to the power x. */
+    inline float exp2(float x) noexcept
+    {
+        x = detail::clamp(x, -126.0f, 126.0f);
+
+        // Split into a round integer and a fraction in [-0.5, 0.5]. The offset keeps the
+        // truncating conversion rounding to nearest for negative inputs too.
+        const std::int32_t whole = static_cast<std::int32_t>(x + 128.5f) - 128;
+        const float fraction = x - static_cast<float>(whole);
+
+        // Taylor series of 2^f = e^(f ln 2), accurate to float precision on [-0.5, 0.5]
+        const float p = 1.0f + fraction * (6.93147181e-1f + fraction * (2.40226507e-1f + fraction * (5.55041087e-2f
+                      + fraction * (9.61812911e-3f + fraction * (1.33335581e-3f + fraction * 1.54035304e-4f)))));
+
+        // Scale by 2^whole through the exponent bits
+        return p * detail::bitsToFloat((whole + 127) << 23);
+    }
+
+    /** e to the power x. */
+    inline float exp(float x) noexcept
+    {
+        return exp2(x * 1.44269504f);
+    }
+
+    /** Base 2 logarithm of a positive normal float. */
+    inline float log2(float x) noexcept
+    {
+        const std::int32_t bits = detail::floatToBits(x);
+
+        // Split x = 2^exponent * m with m in [sqrt(1/2), sqrt(2)), which keeps the series argument small
+        const std::int32_t exponent = (bits - 0x3f3504f3) >> 23;
+        const float m = detail::bitsToFloat(bits - (exponent << 23));
+
+        // log2(m) = 2 / ln 2 * atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172
+        const float s = (m - 1.0f) / (m + 1.0f);
+        const float s2 = s * s;
+        const float series = s * (2.88539008f + s2 * (9.61796694e-1f + s2 * (5.77078016e-1f + s2 * 4.12198583e-1f)));
+
+        return static_cast<float>(exponent) + series;
+    }
+
+    /** Natural logarithm of a positive normal float. */
+    inline float log(float x) noexcept
+    {
+        return log2(x) * 6.93147181e-1f;
+    }
+
+    /** Hyperbolic tangent. */
+    inline float tanh(float x) noexcept
+    {
+        // tanh is 1 to float precision beyond |x| = 9
+        const float e = exp2(detail::clamp(x, -9.0f, 9.0f) * 2.88539008f);
+        return (e - 1.0f) / (e + 1.0f);
+    }
+
+    /** Converts decibels to a linear gain, like juce::Decibels::decibelsToGain without the floor. */
+    inline float decibelsToGain(float decibels) noexcept
+    {
+        return exp2(decibels * 1.66096405e-1f);   // log2(10) / 20
+    }
+
+    /**
+     * Converts a linear gain to decibels, like juce::Decibels::gainToDecibels.
+     * Gains at or below the floor return minusInfinityDb.
+     */
+    inline float gainToDecibels(float gain, float minusInfinityDb = -100.0f) noexcept
+    {
+        const float decibels = log2(juce::jmax(gain, 1.0e-30f)) * 6.02059991f;   // 20 log10(2)
+        return juce::jmax(decibels, minusInfinityDb);
+    }
+}
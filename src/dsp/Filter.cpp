@@ -1,7 +1,101 @@
 #include "Filter.h"
 
+namespace
+{
+    // Runs numLanes channels through the same biquad side by side. The lanes are
+    // independent, so their feedback chains overlap instead of running back to back,
+    // and the state stays in registers for the whole block.
+    template <int numLanes>
+    void processLanes(float* const* channels, int numSamples,
+                      float b0, float b1, float b2, float a1, float a2,
+                      float* s1, float* s2) noexcept
+    {
+        float z1[numLanes], z2[numLanes];
+
+        for (int c = 0; c < numLanes; ++c)
+        {
+            z1[c] = s1[c];
+            z2[c] = s2[c];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numLanes; ++c)
+            {
+                const float x = channels[c][i];
+                const float y = b0 * x + z1[c];
+                z1[c] = b1 * x - a1 * y + z2[c];
+                z2[c] = b2 * x - a2 * y;
+                channels[c][i] = y;
+            }
+        }
+
+        for (int c = 0; c < numLanes; ++c)
+        {
+            s1[c] = z1[c];
+            s2[c] = z2[c];
+        }
+    }
+
+#if JUCE_USE_SIMD
+    using Lanes = juce::dsp::SIMDRegister<float>;
+
+    // Channels per SIMD group, one per lane: four with SSE and NEON, eight with AVX
+    constexpr int laneCount = static_cast<int>(Lanes::SIMDNumElements);
+    constexpr size_t laneAlignment = Lanes::SIMDRegisterSize;
+
+    // Runs laneCount channels through the same biquad in the lanes of one SIMD register,
+    // so every step of the recursion is one vector operation across the channels. The
+    // planar samples are gathered into an aligned frame on the way in and out.
+    void processSimdLanes(float* const* channels, int numSamples,
+                          float b0, float b1, float b2, float a1, float a2,
+                          float* s1, float* s2) noexcept
+    {
+        alignas(laneAlignment) float frame[laneCount];
+        alignas(laneAlignment) float state1[laneCount];
+        alignas(laneAlignment) float state2[laneCount];
+
+        for (int c = 0; c < laneCount; ++c)
+        {
+            state1[c] = s1[c];
+            state2[c] = s2[c];
+        }
+
+        const auto vb0 = Lanes::expand(b0), vb1 = Lanes::expand(b1), vb2 = Lanes::expand(b2);
+        const auto va1 = Lanes::expand(a1), va2 = Lanes::expand(a2);
+        auto z1 = Lanes::fromRawArray(state1);
+        auto z2 = Lanes::fromRawArray(state2);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int c = 0; c < laneCount; ++c)
+                frame[c] = channels[c][i];
+
+            const auto x = Lanes::fromRawArray(frame);
+            const auto y = vb0 * x + z1;
+            z1 = vb1 * x - va1 * y + z2;
+            z2 = vb2 * x - va2 * y;
+            y.copyToRawArray(frame);
+
+            for (int c = 0; c < laneCount; ++c)
+                channels[c][i] = frame[c];
+        }
+
+        z1.copyToRawArray(state1);
+        z2.copyToRawArray(state2);
+
+        for (int c = 0; c < laneCount; ++c)
+        {
+            s1[c] = state1[c];
+            s2[c] = state2[c];
+        }
+    }
+#endif
+}
+
 SimpleFilter::SimpleFilter()
 {
+    setNumChannels(2);
     updateCoefficients();
 }
 
@@ -15,6 +109,12 @@ void SimpleFilter::setSampleRate(double newSampleRate)
     updateCoefficients();
 }
 
+void SimpleFilter::setNumChannels(int newNumChannels)
+{
+    s1.assign(static_cast<size_t>(juce::jmax(1, newNumChannels)), 0.0f);
+    s2.assign(s1.size(), 0.0f);
+}
+
 void SimpleFilter::setType(FilterType newType)
 {
     type = newType;
@@ -35,28 +135,59 @@ void SimpleFilter::setResonance(float q)
 
 void SimpleFilter::reset()
 {
-    for (int i = 0; i < 2; ++i)
-    {
-        x1[i] = x2[i] = 0.0f;
-        y1[i] = y2[i] = 0.0f;
-    }
+    std::fill(s1.begin(), s1.end(), 0.0f);
+    std::fill(s2.begin(), s2.end(), 0.0f);
 }
 
 float SimpleFilter::processSample(float sample, int channel)
 {
-    // Biquad filter implementation
-    float output = b0 * sample + b1 * x1[channel] + b2 * x2[channel]
-                   - a1 * y1[channel] - a2 * y2[channel];
+    jassert(channel >= 0 && channel < getNumChannels());
 
-    // Update state
-    x2[channel] = x1[channel];
-    x1[channel] = sample;
-    y2[channel] = y1[channel];
-    y1[channel] = output;
+    // Transposed Direct Form II biquad
+    const float output = b0 * sample + s1[channel];
+    s1[channel] = b1 * sample - a1 * output + s2[channel];
+    s2[channel] = b2 * sample - a2 * output;
 
     return output;
 }
 
+void SimpleFilter::processBlock(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    jassert(static_cast<int>(block.getNumChannels()) <= getNumChannels());
+
+    int channel = 0;
+
+#if JUCE_USE_SIMD
+    // Full registers of channels go through SIMD. The rest run as scalar pairs: one or
+    // two channels are bound by the latency of the feedback, which SIMD cannot shorten,
+    // and a part-filled register loses more to the gather than it gains.
+    for (; channel + laneCount <= numChannels; channel += laneCount)
+    {
+        float* channels[laneCount];
+
+        for (int c = 0; c < laneCount; ++c)
+            channels[c] = block.getChannelPointer(static_cast<size_t>(channel + c));
+
+        processSimdLanes(channels, numSamples, b0, b1, b2, a1, a2, s1.data() + channel, s2.data() + channel);
+    }
+#endif
+
+    for (; channel + 2 <= numChannels; channel += 2)
+    {
+        float* channels[2] = { block.getChannelPointer(static_cast<size_t>(channel)),
+                               block.getChannelPointer(static_cast<size_t>(channel + 1)) };
+        processLanes<2>(channels, numSamples, b0, b1, b2, a1, a2, s1.data() + channel, s2.data() + channel);
+    }
+
+    if (channel < numChannels)
+    {
+        float* channels[1] = { block.getChannelPointer(static_cast<size_t>(channel)) };
+        processLanes<1>(channels, numSamples, b0, b1, b2, a1, a2, s1.data() + channel, s2.data() + channel);
+    }
+}
+
 void SimpleFilter::updateCoefficients()
 {
     const float pi = juce::MathConstants<float>::pi;
@@ -2,7 +2,21 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
 
+/**
+ * RBJ biquad (low pass, high pass or band pass) for any number of channels.
+ *
+ * Runs in Transposed Direct Form II, which needs two state values per
+ * channel instead of four. The state is sized by setNumChannels() (two
+ * channels by default), which allocates and so belongs in prepare code.
+ * processBlock() filters every channel of a block in one pass. Groups of
+ * channels as wide as a juce::dsp::SIMDRegister (four with SSE and NEON,
+ * eight with AVX) run in its lanes; the rest step in pairs side by side so
+ * neither waits on its own feedback, with a single-channel kernel for mono
+ * and odd channel counts. processSample() remains for code that has to
+ * filter sample by sample.
+ */
 class SimpleFilter
 {
 public:
@@ -17,6 +31,7 @@ public:
     ~SimpleFilter();
 
     void setSampleRate(double newSampleRate);
+    void setNumChannels(int newNumChannels);
     void setType(FilterType newType);
     void setCutoff(float cutoffHz);
     void setResonance(float q);
@@ -24,6 +39,11 @@ public:
     void reset();
     float processSample(float sample, int channel);
 
+    /** Filters a block in place. Channels past getNumChannels() are left untouched. */
+    void processBlock(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    int getNumChannels() const noexcept { return static_cast<int>(s1.size()); }
+
 private:
     void updateCoefficients();
 
@@ -36,11 +56,9 @@ private:
     float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
     float a1 = 0.0f, a2 = 0.0f;
 
-    // State variables (stereo)
-    float x1[2] = { 0.0f, 0.0f };
-    float x2[2] = { 0.0f, 0.0f };
-    float y1[2] = { 0.0f, 0.0f };
-    float y2[2] = { 0.0f, 0.0f };
+    // Transposed Direct Form II state, per channel
+    std::vector<float> s1;
+    std::vector<float> s2;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleFilter)
 };
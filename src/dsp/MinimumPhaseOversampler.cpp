@@ -0,0 +1,175 @@
+#include "MinimumPhaseOversampler.h"
+
+namespace
+{
+    // Half-band allpass coefficients, designed offline with the elliptic (polyphase IIR)
+    // method. Even entries feed one path and odd entries the other. Transition bands
+    // are relative to each stage's output rate. The first keeps the passband to 0.42 of
+    // the base Nyquist, and the later ones only need to clear the images of that band.
+    constexpr float firstStage[] = { 0.040633461f, 0.15050513f, 0.30075706f, 0.46077450f,    // Transition 0.04, 99 dB
+                                     0.60952431f, 0.73850384f, 0.84922381f, 0.94974278f };
+    constexpr float secondStage[] = { 0.062142648f, 0.23238691f, 0.48016451f, 0.79891108f }; // Transition 0.145, 83 dB
+    constexpr float thirdStage[] = { 0.049992355f, 0.19496614f, 0.42872899f, 0.76830643f };  // Transition 0.1975, 99 dB
+    constexpr float fourthStage[] = { 0.075527579f, 0.29975101f, 0.69686209f };               // Transition 0.224, 83 dB
+
+    struct CoefficientSet
+    {
+        const float* coefficients;
+        int size;
+    };
+
+    constexpr CoefficientSet stageCoefficients[] = { { firstStage, static_cast<int>(std::size(firstStage)) },
+                                                     { secondStage, static_cast<int>(std::size(secondStage)) },
+                                                     { thirdStage, static_cast<int>(std::size(thirdStage)) },
+                                                     { fourthStage, static_cast<int>(std::size(fourthStage)) } };
+
+    // Group delay at DC of a first-order allpass section in z^-2, in samples at the higher rate
+    float sectionDelay(float coefficient) noexcept
+    {
+        return 2.0f * (1.0f - coefficient) / (1.0f + coefficient);
+    }
+}
+
+MinimumPhaseOversampler::MinimumPhaseOversampler(size_t newNumChannels, size_t factorLog2)
+    : numChannels(newNumChannels)
+{
+    jassert(factorLog2 >= 1 && factorLog2 <= maxStages);
+    stages.resize(juce::jlimit<size_t>(1, maxStages, factorLog2));
+
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        auto& stage = stages[i];
+        const auto& set = stageCoefficients[i];
+
+        for (int c = 0; c < set.size; ++c)
+        {
+            auto& path = (c % 2 == 0) ? stage.even : stage.odd;
+            path.coefficients[static_cast<size_t>(path.numSections++)] = set.coefficients[c];
+        }
+
+        // The filter's delay is the mean of its two paths', the odd one a sample later.
+        // Up and down together take it twice, less the half sample the decimation phase saves.
+        float filterDelay = 1.0f;
+
+        for (int c = 0; c < set.size; ++c)
+            filterDelay += sectionDelay(set.coefficients[c]);
+
+        filterDelay *= 0.5f;
+        latency += (2.0f * filterDelay - 1.0f) / static_cast<float>(2 << i);
+
+        stage.channels.resize(numChannels);
+    }
+}
+
+MinimumPhaseOversampler::~MinimumPhaseOversampler()
+{
+}
+
+void MinimumPhaseOversampler::initProcessing(size_t maximumNumberOfSamplesBeforeOversampling)
+{
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        const auto numSamples = maximumNumberOfSamplesBeforeOversampling << (i + 1);
+        stages[i].buffer.setSize(static_cast<int>(numChannels), static_cast<int>(numSamples), false, false, true);
+    }
+
+    reset();
+}
+
+void MinimumPhaseOversampler::reset() noexcept
+{
+    for (auto& stage : stages)
+    {
+        std::fill(stage.channels.begin(), stage.channels.end(), ChannelState {});
+        stage.buffer.clear();
+    }
+}
+
+juce::dsp::AudioBlock<float> MinimumPhaseOversampler::processSamplesUp(const juce::dsp::AudioBlock<const float>& inputBlock) noexcept
+{
+    numSamplesUp = static_cast<int>(inputBlock.getNumSamples());
+    jassert(numSamplesUp <= stages.front().buffer.getNumSamples() / 2);
+
+    const auto channels = juce::jmin(numChannels, inputBlock.getNumChannels());
+
+    for (size_t channel = 0; channel < channels; ++channel)
+    {
+        const int ch = static_cast<int>(channel);
+        const float* input = inputBlock.getChannelPointer(channel);
+        int numSamples = numSamplesUp;
+
+        for (auto& stage : stages)
+        {
+            float* output = stage.buffer.getWritePointer(ch);
+            upsampleStage(stage, input, output, numSamples, ch);
+            input = output;
+            numSamples *= 2;
+        }
+    }
+
+    return juce::dsp::AudioBlock<float>(stages.back().buffer).getSubsetChannelBlock(0, channels)
+                                                             .getSubBlock(0, static_cast<size_t>(numSamplesUp) << stages.size());
+}
+
+void MinimumPhaseOversampler::processSamplesDown(juce::dsp::AudioBlock<float>& outputBlock) noexcept
+{
+    jassert(static_cast<int>(outputBlock.getNumSamples()) == numSamplesUp);
+
+    const auto channels = juce::jmin(numChannels, outputBlock.getNumChannels());
+
+    for (size_t channel = 0; channel < channels; ++channel)
+    {
+        const int ch = static_cast<int>(channel);
+        int numSamples = numSamplesUp << (stages.size() - 1);
+
+        // Down through the stages, each decimating into the buffer of the stage below (counts are output samples)
+        for (size_t i = stages.size(); i-- > 0;)
+        {
+            const float* input = stages[i].buffer.getReadPointer(ch);
+            float* output = i > 0 ? stages[i - 1].buffer.getWritePointer(ch) : outputBlock.getChannelPointer(channel);
+            downsampleStage(stages[i], input, output, numSamples, ch);
+            numSamples /= 2;
+        }
+    }
+}
+
+float MinimumPhaseOversampler::Path::process(float input, PathMemory& memory) const noexcept
+{
+    // y = c (x - y[n-1]) + x[n-1] per section, where a section's input is the previous one's output
+    for (int i = 0; i < numSections; ++i)
+    {
+        const float output = coefficients[static_cast<size_t>(i)] * (input - memory[static_cast<size_t>(i + 1)])
+                           + memory[static_cast<size_t>(i)];
+        memory[static_cast<size_t>(i)] = input;
+        input = output;
+    }
+
+    memory[static_cast<size_t>(numSections)] = input;
+    return input;
+}
+
+void MinimumPhaseOversampler::upsampleStage(Stage& stage, const float* input, float* output,
+                                            int numSamples, int channel) noexcept
+{
+    auto& state = stage.channels[static_cast<size_t>(channel)];
+
+    // Each path produces one phase of the interpolated output
+    for (int i = 0; i < numSamples; ++i)
+    {
+        output[2 * i] = stage.even.process(input[i], state.upEven);
+        output[2 * i + 1] = stage.odd.process(input[i], state.upOdd);
+    }
+}
+
+void MinimumPhaseOversampler::downsampleStage(Stage& stage, const float* input, float* output,
+                                              int numSamples, int channel) noexcept
+{
+    auto& state = stage.channels[static_cast<size_t>(channel)];
+
+    // The half-band filter evaluated only at the kept phase: each path takes one input phase
+    for (int i = 0; i < numSamples; ++i)
+    {
+        output[i] = 0.5f * (stage.even.process(input[2 * i + 1], state.downEven)
+                            + stage.odd.process(input[2 * i], state.downOdd));
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <iterator>
+#include <vector>
+
+/**
+ * Low-latency oversampling with minimum-phase half-band filters.
+ *
+ * Each 2x stage is a two-path polyphase allpass half-band filter: every
+ * path is a short cascade of first-order allpass sections running at the
+ * lower rate. These filters have no pre-ringing and a group delay of a few
+ * samples. A linear-phase FIR adds tens of samples at every stage, so this
+ * suits live monitoring. The cost is phase shift near the top of the band.
+ *
+ * The coefficients are precomputed per stage. The first stage has a
+ * narrow transition band, so it needs the most sections. Later stages only
+ * reject images of an already band-limited signal and need fewer.
+ *
+ * Minimum-phase filters have no exact delay, so getLatencyInSamples()
+ * returns their group delay at low frequencies. That is the delay that
+ * matters for lining up a guitar signal.
+ *
+ * The interface follows juce::dsp::Oversampling: initProcessing() allocates
+ * and belongs in prepare code, the processing calls are real-time safe.
+ */
+class MinimumPhaseOversampler
+{
+public:
+    /**
+     * @param numChannels The number of channels to process
+     * @param factorLog2 The number of 2x stages (1 to maxStages)
+     */
+    MinimumPhaseOversampler(size_t numChannels, size_t factorLog2);
+    ~MinimumPhaseOversampler();
+
+    /** Allocates the stage buffers for blocks of up to this many samples at the base rate. */
+    void initProcessing(size_t maximumNumberOfSamplesBeforeOversampling);
+
+    /** Clears every filter's state. */
+    void reset() noexcept;
+
+    /** Upsamples a block and returns the oversampled block, which stays valid until the next call. */
+    juce::dsp::AudioBlock<float> processSamplesUp(const juce::dsp::AudioBlock<const float>& inputBlock) noexcept;
+
+    /** Downsamples the block returned by processSamplesUp() into the output block. */
+    void processSamplesDown(juce::dsp::AudioBlock<float>& outputBlock) noexcept;
+
+    /** Round-trip group delay at low frequencies, in base-rate samples. */
+    float getLatencyInSamples() const noexcept { return latency; }
+
+    size_t getOversamplingFactor() const noexcept { return static_cast<size_t>(1) << stages.size(); }
+
+    static constexpr size_t maxStages = 4;
+
+private:
+    static constexpr int maxSectionsPerPath = 4;
+
+    /** The allpass memory of one path: the previous input of each section, then the previous output. */
+    using PathMemory = std::array<float, maxSectionsPerPath + 1>;
+
+    /** One path's first-order allpass cascade, in z^-2 at the higher rate. */
+    struct Path
+    {
+        std::array<float, maxSectionsPerPath> coefficients {};
+        int numSections = 0;
+
+        float process(float input, PathMemory& memory) const noexcept;
+    };
+
+    struct ChannelState
+    {
+        PathMemory upEven {}, upOdd {}, downEven {}, downOdd {};
+    };
+
+    /** One 2x stage: its filter, the state per channel, and its upsampled output. */
+    struct Stage
+    {
+        Path even, odd;
+        std::vector<ChannelState> channels;
+        juce::AudioBuffer<float> buffer;
+    };
+
+    void upsampleStage(Stage& stage, const float* input, float* output, int numSamples, int channel) noexcept;
+    void downsampleStage(Stage& stage, const float* input, float* output, int numSamples, int channel) noexcept;
+
+    std::vector<Stage> stages;
+    size_t numChannels;
+    int numSamplesUp = 0;   // Base-rate length of the block last upsampled
+    float latency = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MinimumPhaseOversampler)
+};
@@ -0,0 +1,60 @@
+#include "Oversampler.h"
+
+Oversampler::Oversampler(size_t numChannels, size_t numStages, FilterType newFilterType)
+    : filterType(newFilterType)
+{
+    if (filterType == FilterType::MinimumPhase)
+    {
+        minimumPhaseOversampling = std::make_unique<MinimumPhaseOversampler>(numChannels, numStages);
+        return;
+    }
+
+    const auto juceFilterType = filterType == FilterType::LinearPhase
+                                    ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                                    : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR;
+    halfBandOversampling = std::make_unique<juce::dsp::Oversampling<float>>(numChannels, numStages, juceFilterType, true, true);
+}
+
+Oversampler::~Oversampler()
+{
+}
+
+void Oversampler::initProcessing(size_t maximumNumberOfSamplesBeforeOversampling)
+{
+    if (minimumPhaseOversampling != nullptr)
+        minimumPhaseOversampling->initProcessing(maximumNumberOfSamplesBeforeOversampling);
+    else
+        halfBandOversampling->initProcessing(maximumNumberOfSamplesBeforeOversampling);
+}
+
+void Oversampler::reset() noexcept
+{
+    if (minimumPhaseOversampling != nullptr)
+        minimumPhaseOversampling->reset();
+    else
+        halfBandOversampling->reset();
+}
+
+juce::dsp::AudioBlock<float> Oversampler::processSamplesUp(const juce::dsp::AudioBlock<const float>& inputBlock) noexcept
+{
+    if (minimumPhaseOversampling != nullptr)
+        return minimumPhaseOversampling->processSamplesUp(inputBlock);
+
+    return halfBandOversampling->processSamplesUp(inputBlock);
+}
+
+void Oversampler::processSamplesDown(juce::dsp::AudioBlock<float>& outputBlock) noexcept
+{
+    if (minimumPhaseOversampling != nullptr)
+        minimumPhaseOversampling->processSamplesDown(outputBlock);
+    else
+        halfBandOversampling->processSamplesDown(outputBlock);
+}
+
+int Oversampler::getLatencyInSamples() const noexcept
+{
+    if (minimumPhaseOversampling != nullptr)
+        return juce::roundToInt(minimumPhaseOversampling->getLatencyInSamples());
+
+    return juce::roundToInt(halfBandOversampling->getLatencyInSamples());
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include "MinimumPhaseOversampler.h"
+
+/**
+ * Oversampling with a choice of filter design behind one interface, so a
+ * processor can switch designs at runtime.
+ *
+ * IIR and LinearPhase use juce::dsp::Oversampling's half-band filters with
+ * integer latency, so hosts can compensate it exactly. MinimumPhase uses
+ * MinimumPhaseOversampler, whose latency is a fraction of a millisecond and
+ * is reported rounded to whole samples.
+ *
+ * The interface follows juce::dsp::Oversampling: construction and
+ * initProcessing() allocate, the processing calls are real-time safe.
+ */
+class Oversampler
+{
+public:
+    enum class FilterType
+    {
+        IIR,            // Polyphase half-band IIR: cheap, low latency, non-linear phase
+        LinearPhase,    // Equiripple half-band FIR: more CPU and latency, linear phase
+        MinimumPhase    // Precomputed allpass half-bands: the lowest latency, for live monitoring
+    };
+
+    /**
+     * @param numChannels The number of channels to process
+     * @param numStages The number of 2x stages (1 to 4)
+     * @param filterType The filter design
+     */
+    Oversampler(size_t numChannels, size_t numStages, FilterType filterType);
+    ~Oversampler();
+
+    void initProcessing(size_t maximumNumberOfSamplesBeforeOversampling);
+    void reset() noexcept;
+
+    juce::dsp::AudioBlock<float> processSamplesUp(const juce::dsp::AudioBlock<const float>& inputBlock) noexcept;
+    void processSamplesDown(juce::dsp::AudioBlock<float>& outputBlock) noexcept;
+
+    /** The round-trip latency in base-rate samples. */
+    int getLatencyInSamples() const noexcept;
+
+    FilterType getFilterType() const noexcept { return filterType; }
+
+private:
+    FilterType filterType;
+
+    // Exactly one of these is set, depending on the filter type
+    std::unique_ptr<juce::dsp::Oversampling<float>> halfBandOversampling;
+    std::unique_ptr<MinimumPhaseOversampler> minimumPhaseOversampling;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Oversampler)
+};
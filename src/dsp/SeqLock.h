@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Single-writer, multi-reader sequence lock for small trivially copyable values.
+ *
+ * The writer never blocks or allocates, so it is safe on audio and analysis
+ * threads. Readers retry if they overlap a write and therefore always see a
+ * value that was published as a whole. The payload is held in relaxed atomic
+ * words, so no data race exists even while a reader is retrying.
+ */
+template <typename T>
+class SeqLock
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values must be trivially copyable");
+
+    SeqLock() { store(T {}); }
+
+    /** Publishes a new value. Only one thread may call this. */
+    void store(const T& value) noexcept
+    {
+        Words words {};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const auto sequence = sequenceNumber.load(std::memory_order_relaxed);
+        sequenceNumber.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < numWords; ++i)
+            payload[i].store(words[i], std::memory_order_relaxed);
+
+        sequenceNumber.store(sequence + 2, std::memory_order_release);
+    }
+
+    /** Returns the most recently published value. Safe from any thread. */
+    T load() const noexcept
+    {
+        Words words {};
+
+        for (;;)
+        {
+            const auto before = sequenceNumber.load(std::memory_order_acquire);
+
+            // Odd means a write is in progress
+            if ((before & 1) != 0)
+                continue;
+
+            for (size_t i = 0; i < numWords; ++i)
+                words[i] = payload[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequenceNumber.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t numWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    using Words = std::array<uint32_t, numWords>;
+
+    std::atomic<uint32_t> sequenceNumber { 0 };
+    std::array<std::atomic<uint32_t>, numWords> payload {};
+};
@@ -0,0 +1,97 @@
+#include "SmoothedParameter.h"
+
+SmoothedParameter::SmoothedParameter(float initialValue)
+    : currentValue(initialValue), targetValue(initialValue)
+{
+}
+
+void SmoothedParameter::prepare(double sampleRate, int maximumBlockSize, double rampLengthSeconds)
+{
+    ramp.assign(static_cast<size_t>(juce::jmax(1, maximumBlockSize)), 0.0f);
+    setSampleRate(sampleRate, rampLengthSeconds);
+}
+
+void SmoothedParameter::setSampleRate(double sampleRate, double rampLengthSeconds) noexcept
+{
+    rampLengthSamples = juce::jmax(0, juce::roundToInt(sampleRate * rampLengthSeconds));
+    setCurrentAndTargetValue(targetValue);
+}
+
+void SmoothedParameter::setTargetValue(float newValue) noexcept
+{
+    if (newValue == targetValue)
+        return;
+
+    targetValue = newValue;
+
+    if (rampLengthSamples == 0)
+    {
+        setCurrentAndTargetValue(newValue);
+        return;
+    }
+
+    stepsRemaining = rampLengthSamples;
+    step = (targetValue - currentValue) / static_cast<float>(rampLengthSamples);
+}
+
+void SmoothedParameter::setCurrentAndTargetValue(float newValue) noexcept
+{
+    currentValue = targetValue = newValue;
+    stepsRemaining = 0;
+    step = 0.0f;
+}
+
+const float* SmoothedParameter::getRamp(int numSamples) noexcept
+{
+    if (stepsRemaining == 0)
+        return nullptr;
+
+    if (numSamples > static_cast<int>(ramp.size()))
+    {
+        jassertfalse;   // Larger than prepared for
+        setCurrentAndTargetValue(targetValue);
+        return nullptr;
+    }
+
+    auto* data = ramp.data();
+    const int rampSamples = juce::jmin(stepsRemaining, numSamples);
+    const float start = currentValue;
+
+    // Each value is computed from the start rather than accumulated, so the
+    // loop has no carried dependency and vectorizes
+    for (int i = 0; i < rampSamples; ++i)
+        data[i] = start + step * static_cast<float>(i + 1);
+
+    stepsRemaining -= rampSamples;
+
+    // Land exactly on the target once the ramp is done
+    if (stepsRemaining == 0)
+    {
+        currentValue = targetValue;
+        data[rampSamples - 1] = targetValue;
+    }
+    else
+    {
+        currentValue = data[rampSamples - 1];
+    }
+
+    if (rampSamples < numSamples)
+        juce::FloatVectorOperations::fill(data + rampSamples, targetValue, numSamples - rampSamples);
+
+    return data;
+}
+
+void SmoothedParameter::applyGain(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    if (const auto* gains = getRamp(numSamples))
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::multiply(block.getChannelPointer(channel), gains, numSamples);
+    }
+    else if (currentValue != 1.0f)
+    {
+        block.multiplyBy(currentValue);
+    }
+}
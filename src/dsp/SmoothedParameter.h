@@ -0,0 +1,72 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+/**
+ * A parameter value that ramps linearly to each new target instead of
+ * stepping, for zipper-free automation of gains, mixes and depths.
+ *
+ * While a ramp is running, getRamp() fills a scratch buffer with one value
+ * per sample in a loop the compiler vectorizes, and every channel of the
+ * block reads the same buffer. When the value is steady getRamp() returns
+ * nullptr and callers keep their scalar path, so a parameter that does not
+ * move costs the same as a plain float.
+ *
+ * prepare() allocates. Everything else is real-time safe and belongs to the
+ * audio thread.
+ */
+class SmoothedParameter
+{
+public:
+    explicit SmoothedParameter(float initialValue = 0.0f);
+
+    /**
+     * Sizes the ramp buffer and sets the ramp length.
+     * @param sampleRate The rate getRamp() advances at
+     * @param maximumBlockSize The most samples getRamp() will be asked for at once
+     * @param rampLengthSeconds How long a change takes to reach its target
+     */
+    void prepare(double sampleRate, int maximumBlockSize, double rampLengthSeconds = defaultRampLengthSeconds);
+
+    /**
+     * Changes the rate getRamp() advances at without reallocating, for code that
+     * switches sample rate on the audio thread. Ends any ramp.
+     */
+    void setSampleRate(double sampleRate, double rampLengthSeconds = defaultRampLengthSeconds) noexcept;
+
+    /** Starts a ramp from the current value to newValue. Does nothing if it is already the target. */
+    void setTargetValue(float newValue) noexcept;
+
+    /** Jumps straight to newValue, ending any ramp. */
+    void setCurrentAndTargetValue(float newValue) noexcept;
+
+    float getCurrentValue() const noexcept { return currentValue; }
+    float getTargetValue() const noexcept { return targetValue; }
+    bool isSmoothing() const noexcept { return stepsRemaining > 0; }
+
+    /**
+     * Advances by numSamples and returns the value at each of them, or nullptr
+     * if the value is steady (use getCurrentValue()). The buffer stays valid
+     * until the next call. Asking for more than maximumBlockSize samples
+     * finishes the ramp at once and returns nullptr.
+     */
+    const float* getRamp(int numSamples) noexcept;
+
+    /** Multiplies every channel of a block by the value, ramping if needed. */
+    void applyGain(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    static constexpr double defaultRampLengthSeconds = 0.02;
+
+private:
+    std::vector<float> ramp;
+    float currentValue;
+    float targetValue;
+    float step = 0.0f;
+    int stepsRemaining = 0;
+    int rampLengthSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SmoothedParameter)
+};
@@ -0,0 +1,259 @@
+#include "StateVariableFilter.h"
+
+namespace
+{
+    // Picks one response from the integrator outputs (v1 = band pass, v2 = low pass)
+    template <StateVariableFilter::OutputType type>
+    inline float selectOutput(float input, float v1, float v2, float k) noexcept
+    {
+        using OutputType = StateVariableFilter::OutputType;
+
+        if constexpr (type == OutputType::LowPass)
+            return v2;
+        else if constexpr (type == OutputType::HighPass)
+            return input - k * v1 - v2;
+        else if constexpr (type == OutputType::BandPass)
+            return v1;
+        else
+            return input - k * v1;
+    }
+}
+
+StateVariableFilter::StateVariableFilter()
+{
+    setNumChannels(2);
+    updateCoefficients(cutoff.getCurrentValue());
+}
+
+StateVariableFilter::~StateVariableFilter()
+{
+}
+
+void StateVariableFilter::setSampleRate(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    cutoff.reset(sampleRate, smoothingSeconds);
+    control.reset(sampleRate, smoothingSeconds);
+    updateCoefficients(cutoff.getCurrentValue());
+}
+
+void StateVariableFilter::setNumChannels(int newNumChannels)
+{
+    ic1eq.assign(static_cast<size_t>(juce::jmax(1, newNumChannels)), 0.0f);
+    ic2eq.assign(ic1eq.size(), 0.0f);
+}
+
+void StateVariableFilter::setOutputType(OutputType newType)
+{
+    type = newType;
+}
+
+void StateVariableFilter::setResonance(float q)
+{
+    resonance = juce::jlimit(0.1f, 20.0f, q);
+    k = 1.0f / resonance;
+
+    // A control table carries its own damping
+    if (controlTable == nullptr)
+        updateCoefficients(cutoff.getCurrentValue());
+}
+
+void StateVariableFilter::setCutoff(float cutoffHz)
+{
+    cutoff.setTargetValue(juce::jlimit(20.0f, static_cast<float>(sampleRate * 0.49), cutoffHz));
+}
+
+void StateVariableFilter::setSmoothingTime(double seconds)
+{
+    smoothingSeconds = seconds;
+    cutoff.reset(sampleRate, smoothingSeconds);
+    control.reset(sampleRate, smoothingSeconds);
+}
+
+void StateVariableFilter::setControlTable(const ControlTable* newTable)
+{
+    controlTable = newTable;
+
+    if (controlTable != nullptr)
+        applyControl(control.getCurrentValue());
+    else
+        updateCoefficients(cutoff.getCurrentValue());
+}
+
+void StateVariableFilter::setControl(float normalisedValue)
+{
+    jassert(controlTable != nullptr);
+    control.setTargetValue(juce::jlimit(0.0f, 1.0f, normalisedValue));
+}
+
+void StateVariableFilter::reset()
+{
+    std::fill(ic1eq.begin(), ic1eq.end(), 0.0f);
+    std::fill(ic2eq.begin(), ic2eq.end(), 0.0f);
+
+    cutoff.setCurrentAndTargetValue(cutoff.getTargetValue());
+    control.setCurrentAndTargetValue(control.getTargetValue());
+
+    if (controlTable != nullptr)
+        applyControl(control.getCurrentValue());
+    else
+        updateCoefficients(cutoff.getCurrentValue());
+}
+
+StateVariableFilter::Outputs StateVariableFilter::processSampleOutputs(float sample, int channel) noexcept
+{
+    jassert(channel >= 0 && channel < getNumChannels());
+
+    auto& s1 = ic1eq[static_cast<size_t>(channel)];
+    auto& s2 = ic2eq[static_cast<size_t>(channel)];
+
+    const float v3 = sample - s2;
+    const float v1 = a1 * s1 + a2 * v3;
+    const float v2 = s2 + a2 * s1 + a3 * v3;
+    s1 = 2.0f * v1 - s1;
+    s2 = 2.0f * v2 - s2;
+
+    return { v2, sample - k * v1 - v2, v1, sample - k * v1 };
+}
+
+float StateVariableFilter::processSample(float sample, int channel) noexcept
+{
+    const auto outputs = processSampleOutputs(sample, channel);
+
+    switch (type)
+    {
+        case OutputType::LowPass:  return outputs.lowPass;
+        case OutputType::HighPass: return outputs.highPass;
+        case OutputType::BandPass: return outputs.bandPass;
+        case OutputType::Notch:    return outputs.notch;
+    }
+
+    return outputs.lowPass;
+}
+
+void StateVariableFilter::processBlock(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    jassert(static_cast<int>(block.getNumChannels()) <= getNumChannels());
+    const bool gliding = isGliding();
+
+    switch (type)
+    {
+        case OutputType::LowPass:  gliding ? processGliding<OutputType::LowPass>(block)  : processFixed<OutputType::LowPass>(block);  break;
+        case OutputType::HighPass: gliding ? processGliding<OutputType::HighPass>(block) : processFixed<OutputType::HighPass>(block); break;
+        case OutputType::BandPass: gliding ? processGliding<OutputType::BandPass>(block) : processFixed<OutputType::BandPass>(block); break;
+        case OutputType::Notch:    gliding ? processGliding<OutputType::Notch>(block)    : processFixed<OutputType::Notch>(block);    break;
+    }
+}
+
+template <StateVariableFilter::OutputType outputType>
+void StateVariableFilter::processFixed(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer(static_cast<size_t>(channel));
+        float s1 = ic1eq[static_cast<size_t>(channel)];
+        float s2 = ic2eq[static_cast<size_t>(channel)];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float v3 = data[i] - s2;
+            const float v1 = a1 * s1 + a2 * v3;
+            const float v2 = s2 + a2 * s1 + a3 * v3;
+            s1 = 2.0f * v1 - s1;
+            s2 = 2.0f * v2 - s2;
+            data[i] = selectOutput<outputType>(data[i], v1, v2, k);
+        }
+
+        ic1eq[static_cast<size_t>(channel)] = s1;
+        ic2eq[static_cast<size_t>(channel)] = s2;
+    }
+}
+
+template <StateVariableFilter::OutputType outputType>
+void StateVariableFilter::processGliding(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    // The cutoff is shared by all channels, so retune once per sample
+    for (int i = 0; i < numSamples; ++i)
+    {
+        advanceGlide();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = block.getChannelPointer(static_cast<size_t>(channel));
+            auto& s1 = ic1eq[static_cast<size_t>(channel)];
+            auto& s2 = ic2eq[static_cast<size_t>(channel)];
+
+            const float v3 = data[i] - s2;
+            const float v1 = a1 * s1 + a2 * v3;
+            const float v2 = s2 + a2 * s1 + a3 * v3;
+            s1 = 2.0f * v1 - s1;
+            s2 = 2.0f * v2 - s2;
+            data[i] = selectOutput<outputType>(data[i], v1, v2, k);
+        }
+    }
+}
+
+float StateVariableFilter::prewarp(float normalisedFrequency) noexcept
+{
+    // [5/4] Pade approximant of tan, accurate on [0, pi/4]. Above that,
+    // tan(x) = 1 / tan(pi/2 - x) keeps the argument in range.
+    auto tanPade = [](float x)
+    {
+        const float x2 = x * x;
+        return x * (945.0f - 105.0f * x2 + x2 * x2) / (945.0f - 420.0f * x2 + 15.0f * x2 * x2);
+    };
+
+    const float x = juce::MathConstants<float>::pi * normalisedFrequency;
+
+    if (normalisedFrequency <= 0.25f)
+        return tanPade(x);
+
+    return 1.0f / tanPade(juce::MathConstants<float>::halfPi - x);
+}
+
+StateVariableFilter::ControlTable::Entry StateVariableFilter::makeCoefficients(float cutoffHz, float q,
+                                                                              double sampleRate) noexcept
+{
+    const float damping = 1.0f / juce::jlimit(0.1f, 20.0f, q);
+    const float g = prewarp(juce::jlimit(20.0f, static_cast<float>(sampleRate * 0.49), cutoffHz)
+                            / static_cast<float>(sampleRate));
+    const float c1 = 1.0f / (1.0f + g * (g + damping));
+
+    return { c1, g * c1, g * g * c1, damping };
+}
+
+void StateVariableFilter::updateCoefficients(float cutoffHz) noexcept
+{
+    const float g = prewarp(cutoffHz / static_cast<float>(sampleRate));
+    a1 = 1.0f / (1.0f + g * (g + k));
+    a2 = g * a1;
+    a3 = g * a2;
+}
+
+void StateVariableFilter::applyControl(float normalisedValue) noexcept
+{
+    const auto coefficients = controlTable->lookup(normalisedValue);
+    a1 = coefficients[0];
+    a2 = coefficients[1];
+    a3 = coefficients[2];
+    k = coefficients[3];
+}
+
+bool StateVariableFilter::isGliding() const noexcept
+{
+    return controlTable != nullptr ? control.isSmoothing() : cutoff.isSmoothing();
+}
+
+void StateVariableFilter::advanceGlide() noexcept
+{
+    if (controlTable != nullptr)
+        applyControl(control.getNextValue());
+    else
+        updateCoefficients(cutoff.getNextValue());
+}
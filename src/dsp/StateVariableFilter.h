@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "CoefficientTable.h"
+
+/**
+ * Topology-preserving transform (trapezoidal) state-variable filter.
+ *
+ * Produces low pass, high pass, band pass and notch from the same two
+ * integrators, and stays stable and free of zipper noise while its cutoff
+ * moves every sample. The cutoff prewarp uses a rational tan approximation
+ * (no sin/cos), so retuning costs a handful of multiplies and one division.
+ *
+ * setCutoff() glides to the new cutoff over the smoothing time instead of
+ * jumping, so knob moves and automation sweep smoothly. processBlock() only
+ * takes the per-sample path while a glide is in progress.
+ *
+ * A filter driven by a knob can instead be given a ControlTable, built at
+ * prepare time with makeCoefficients() across the knob's range. setControl()
+ * then glides the knob value and every step is a table lookup.
+ */
+class StateVariableFilter
+{
+public:
+    enum class OutputType
+    {
+        LowPass,
+        HighPass,
+        BandPass,
+        Notch
+    };
+
+    /** Every response for one input sample. */
+    struct Outputs
+    {
+        float lowPass;
+        float highPass;
+        float bandPass;
+        float notch;
+    };
+
+    /** Coefficient set for one cutoff and resonance: a1, a2, a3 and the damping k. */
+    using ControlTable = CoefficientTable<4>;
+
+    StateVariableFilter();
+    ~StateVariableFilter();
+
+    void setSampleRate(double newSampleRate);
+    void setNumChannels(int newNumChannels);
+    void setOutputType(OutputType newType);
+    void setResonance(float q);
+
+    /** Glides to a new cutoff in Hz. Snaps straight to it after reset(). */
+    void setCutoff(float cutoffHz);
+    void setSmoothingTime(double seconds);
+
+    /**
+     * Drives the cutoff from a knob through a precomputed table, or switches back
+     * to setCutoff() when the table is nullptr. The table must outlive its use.
+     */
+    void setControlTable(const ControlTable* newTable);
+
+    /** Glides to a new knob value (0 to 1) in the control table. */
+    void setControl(float normalisedValue);
+
+    /** Clears the integrators and jumps to the target cutoff or control. */
+    void reset();
+
+    /** Filters one sample at the current cutoff and returns every output. */
+    Outputs processSampleOutputs(float sample, int channel) noexcept;
+
+    /** Filters one sample at the current cutoff and returns the selected output. */
+    float processSample(float sample, int channel) noexcept;
+
+    /** Filters a block in place, advancing any cutoff glide sample by sample. */
+    void processBlock(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    int getNumChannels() const noexcept { return static_cast<int>(ic1eq.size()); }
+
+    /**
+     * Returns tan(pi * normalisedFrequency), for normalisedFrequency (cutoff over
+     * sample rate) in [0, 0.5). Relative error stays below 1e-7.
+     */
+    static float prewarp(float normalisedFrequency) noexcept;
+
+    /** Computes a control table entry: the coefficients for a cutoff and Q at a sample rate. */
+    static ControlTable::Entry makeCoefficients(float cutoffHz, float q, double sampleRate) noexcept;
+
+private:
+    void updateCoefficients(float cutoffHz) noexcept;
+    void applyControl(float normalisedValue) noexcept;
+    bool isGliding() const noexcept;
+    void advanceGlide() noexcept;
+
+    template <OutputType type>
+    void processFixed(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    template <OutputType type>
+    void processGliding(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    double sampleRate = 44100.0;
+    OutputType type = OutputType::LowPass;
+    float resonance = 0.707f;
+    double smoothingSeconds = 0.02;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> cutoff { 1000.0f };
+
+    // Knob-driven mode
+    const ControlTable* controlTable = nullptr;
+    juce::SmoothedValue<float> control { 0.5f };
+
+    // Coefficients for the current cutoff
+    float k = 1.0f / 0.707f;   // Damping, 1/Q
+    float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f;
+
+    // Integrator state, per channel
+    std::vector<float> ic1eq;
+    std::vector<float> ic2eq;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StateVariableFilter)
+};
@@ -0,0 +1,104 @@
+#include "Waveshaper.h"
+
+void Waveshaper::process(float* data, int numSamples) const noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        data[i] = processSample(data[i]);
+}
+
+void Waveshaper::processBlock(const juce::dsp::AudioBlock<float>& block) const noexcept
+{
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        process(block.getChannelPointer(channel), numSamples);
+}
+
+double Waveshaper::getAntiderivative(double x) const noexcept
+{
+    jassert(isBuilt());
+
+    // Past the limits the curve is flat, so its antiderivative is a straight line
+    if (x <= -inputLimit)
+        return antiderivatives.front()[0] + lowerLimitValue * (x + inputLimit);
+
+    if (x >= inputLimit)
+        return antiderivatives.back()[0] + upperLimitValue * (x - inputLimit);
+
+    double t;
+    const int index = locate(x, t);
+    const auto& s = segments[static_cast<size_t>(index)];
+    const double width = 1.0 / segmentsPerUnit;
+
+    return antiderivatives[static_cast<size_t>(index)][0]
+         + width * t * (s.c0 + t * (s.c1 / 2.0 + t * (s.c2 / 3.0 + t * s.c3 / 4.0)));
+}
+
+double Waveshaper::getSecondAntiderivative(double x) const noexcept
+{
+    jassert(isBuilt());
+
+    if (x <= -inputLimit)
+    {
+        const double d = x + inputLimit;
+        return antiderivatives.front()[1] + antiderivatives.front()[0] * d + 0.5 * lowerLimitValue * d * d;
+    }
+
+    if (x >= inputLimit)
+    {
+        const double d = x - inputLimit;
+        return antiderivatives.back()[1] + antiderivatives.back()[0] * d + 0.5 * upperLimitValue * d * d;
+    }
+
+    double t;
+    const int index = locate(x, t);
+    const auto& s = segments[static_cast<size_t>(index)];
+    const auto& start = antiderivatives[static_cast<size_t>(index)];
+    const double width = 1.0 / segmentsPerUnit;
+
+    return start[1] + start[0] * width * t
+         + width * width * t * t * (s.c0 / 2.0 + t * (s.c1 / 6.0 + t * (s.c2 / 12.0 + t * s.c3 / 20.0)));
+}
+
+void Waveshaper::buildAntiderivatives()
+{
+    const double width = 1.0 / segmentsPerUnit;
+
+    antiderivatives.resize(segments.size() + 1);
+    antiderivatives.front() = { 0.0, 0.0 };
+
+    // Each segment's polynomial integrated over its full width (t = 0 to 1)
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        const auto& s = segments[i];
+        const auto& start = antiderivatives[i];
+
+        antiderivatives[i + 1] = { start[0] + width * (s.c0 + s.c1 / 2.0 + s.c2 / 3.0 + s.c3 / 4.0),
+                                   start[1] + start[0] * width
+                                       + width * width * (s.c0 / 2.0 + s.c1 / 6.0 + s.c2 / 12.0 + s.c3 / 20.0) };
+    }
+
+    const auto& last = segments.back();
+    lowerLimitValue = segments.front().c0;
+    upperLimitValue = last.c0 + last.c1 + last.c2 + last.c3;
+
+    // Shift the integration constants so both antiderivatives are zero at x = 0.
+    // ADAA divides differences of these values, and small magnitudes keep those precise.
+    const double first = getAntiderivative(0.0);
+    const double second = getSecondAntiderivative(0.0);
+
+    for (size_t i = 0; i < antiderivatives.size(); ++i)
+    {
+        const double x = -inputLimit + width * static_cast<double>(i);
+        antiderivatives[i][0] -= first;
+        antiderivatives[i][1] -= first * x + second;
+    }
+}
+
+int Waveshaper::locate(double x, double& t) const noexcept
+{
+    const double position = (x + inputLimit) * segmentsPerUnit;
+    const int index = juce::jlimit(0, lastSegment, static_cast<int>(position));
+    t = position - static_cast<double>(index);
+    return index;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+/**
+ * Memoryless waveshaper driven by a table of its transfer curve.
+ *
+ * build() samples any curve y = f(x) across [-inputLimit, inputLimit] once,
+ * and stores one cubic (Catmull-Rom) segment per table step. After that,
+ * shaping a sample is a clamp, one table index and a cubic in Horner form,
+ * whatever the curve costs to evaluate, so a new drive model only needs a
+ * curve function. Inputs beyond the limit are clamped to it, so choose a
+ * limit past the point where the curve has flattened out.
+ *
+ * The default table (1024 segments of four floats, 16 KB) stays in L1 cache.
+ * The block loops look samples up lane by lane with no branches, so
+ * compilers can vectorize them with gathers where the target has them.
+ *
+ * Curves with a jump (a hard clip that steps) ring slightly in the
+ * segments next to the jump, as any cubic interpolation does.
+ *
+ * build() also integrates the segments, once and twice, into exact
+ * antiderivatives of the interpolated curve (in double precision, zero at
+ * x = 0, and continued past the limits where the curve is flat). These feed
+ * AntialiasedWaveshaper.
+ *
+ * build() allocates and belongs in construction or prepare code. Everything
+ * else is real-time safe.
+ */
+class Waveshaper
+{
+public:
+    Waveshaper() = default;
+
+    /**
+     * Samples a transfer curve into the table.
+     * @param curve Maps an input sample to its shaped value
+     * @param newInputLimit Half-width of the input range the table covers
+     * @param numSegments Number of cubic segments across the range
+     */
+    template <typename Curve>
+    void build(Curve&& curve, float newInputLimit, int numSegments = defaultNumSegments)
+    {
+        jassert(newInputLimit > 0.0f && numSegments >= 2);
+
+        inputLimit = newInputLimit;
+        lastSegment = numSegments - 1;
+        segmentsPerUnit = static_cast<float>(numSegments) / (2.0f * inputLimit);
+
+        const float step = 1.0f / segmentsPerUnit;
+        auto sampleAt = [&](int point) { return static_cast<float>(curve(-inputLimit + step * static_cast<float>(point))); };
+
+        segments.resize(static_cast<size_t>(numSegments));
+
+        // Segment i spans points i and i + 1; its outer neighbours set the slopes,
+        // so the curve is sampled one step beyond each end of the range
+        for (int i = 0; i < numSegments; ++i)
+        {
+            const float y0 = sampleAt(i - 1);
+            const float y1 = sampleAt(i);
+            const float y2 = sampleAt(i + 1);
+            const float y3 = sampleAt(i + 2);
+
+            segments[static_cast<size_t>(i)] = { y1,
+                                                 0.5f * (y2 - y0),
+                                                 y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3,
+                                                 0.5f * (y3 - y0) + 1.5f * (y1 - y2) };
+        }
+
+        buildAntiderivatives();
+    }
+
+    /** Shapes one sample. */
+    float processSample(float sample) const noexcept
+    {
+        jassert(isBuilt());
+
+        // min/max rather than jlimit, which keeps the block loops branch-free
+        const float clamped = std::min(inputLimit, std::max(-inputLimit, sample));
+        const float position = (clamped + inputLimit) * segmentsPerUnit;
+        const int index = std::min(static_cast<int>(position), lastSegment);
+        const float t = position - static_cast<float>(index);
+
+        const auto& segment = segments[static_cast<size_t>(index)];
+        return segment.c0 + t * (segment.c1 + t * (segment.c2 + t * segment.c3));
+    }
+
+    /** Shapes a run of samples in place. */
+    void process(float* data, int numSamples) const noexcept;
+
+    /** Shapes every channel of a block in place. */
+    void processBlock(const juce::dsp::AudioBlock<float>& block) const noexcept;
+
+    /** First antiderivative of the shaped curve at x, any x. */
+    double getAntiderivative(double x) const noexcept;
+
+    /** Second antiderivative of the shaped curve at x, any x. */
+    double getSecondAntiderivative(double x) const noexcept;
+
+    bool isBuilt() const noexcept { return !segments.empty(); }
+    float getInputLimit() const noexcept { return inputLimit; }
+
+    static constexpr int defaultNumSegments = 1024;
+
+private:
+    /** One cubic: c0 + c1 t + c2 t^2 + c3 t^3 for t in [0, 1) across the segment. */
+    struct Segment
+    {
+        float c0, c1, c2, c3;
+    };
+
+    // Integrates each segment into the antiderivative values at the segment starts
+    void buildAntiderivatives();
+
+    // Finds the segment holding x (within the limits) and the position t across it
+    int locate(double x, double& t) const noexcept;
+
+    std::vector<Segment> segments;
+
+    // First and second antiderivative at the start of each segment, and at the upper limit
+    std::vector<std::array<double, 2>> antiderivatives;
+
+    // The curve's values at the limits, held constant beyond them
+    float lowerLimitValue = 0.0f;
+    float upperLimitValue = 0.0f;
+
+    float inputLimit = 1.0f;
+    float segmentsPerUnit = 1.0f;
+    int lastSegment = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Waveshaper)
+};
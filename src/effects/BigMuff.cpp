@@ -1,8 +1,18 @@
 #include "BigMuff.h"
+#include "../dsp/FastMath.h"
 #include <cmath>
 
 BigMuff::BigMuff()
 {
+    for (size_t stage = 0; stage < stageClippers.size(); ++stage)
+    {
+        const float threshold = stageThresholds[stage];
+        stageClippers[stage].build([threshold](float sample) { return clipStage(sample, threshold); }, clipperInputLimit);
+        stageAntialiasers[stage].setShaper(stageClippers[stage]);
+    }
+
+    outputClipper.build(outputClip, clipperInputLimit);
+    outputAntialiaser.setShaper(outputClipper);
 }
 
 BigMuff::~BigMuff()
@@ -14,6 +24,15 @@ void BigMuff::prepare(double sampleRate, int samplesPerBlock)
     this->sampleRate = sampleRate;
     this->samplesPerBlock = samplesPerBlock;
 
+    // Every filter carries state for each channel
+    for (auto* filter : { &inputFilter, &lowPassFilter, &highPassFilter, &midCutFilter })
+        filter->setNumChannels(numChannels);
+
+    for (auto& antialiaser : stageAntialiasers)
+        antialiaser.setNumChannels(numChannels);
+
+    outputAntialiaser.setNumChannels(numChannels);
+
     // Input high-pass to remove DC and rumble
     inputFilter.setType(SimpleFilter::FilterType::HighPass);
     inputFilter.setSampleRate(sampleRate);
@@ -34,6 +53,27 @@ void BigMuff::prepare(double sampleRate, int samplesPerBlock)
     midCutFilter.setCutoff(800.0f);
     midCutFilter.setResonance(0.5f);
 
+    trebleBuffer.setSize(numChannels, samplesPerBlock);
+    midBuffer.setSize(numChannels, samplesPerBlock);
+    dcBlockers.assign(static_cast<size_t>(numChannels), DcBlockerState {});
+    couplingStates.resize(static_cast<size_t>((numChannels + laneCount - 1) / laneCount));
+
+    // Coupling filter one-pole coefficients at the rate the stages run at
+    const double highPassPole = std::exp(-juce::MathConstants<double>::twoPi * couplingHighPassHz / sampleRate);
+
+    for (size_t coupling = 0; coupling < numCouplings; ++coupling)
+    {
+        const double lowPassPole = std::exp(-juce::MathConstants<double>::twoPi * couplingLowPassHz[coupling] / sampleRate);
+        highPassCoefficients[coupling] = static_cast<float>(highPassPole);
+        lowPassCoefficients[coupling] = static_cast<float>(1.0 - lowPassPole);
+    }
+
+    sustainGain.prepare(sampleRate, samplesPerBlock);
+    volumeGain.prepare(sampleRate, samplesPerBlock);
+    sustainGain.setCurrentAndTargetValue(getSustainGain(sustain));
+    volumeGain.setCurrentAndTargetValue(volume);
+
+    markParametersChanged();
     reset();
 }
 
@@ -43,8 +83,15 @@ void BigMuff::reset()
     lowPassFilter.reset();
     highPassFilter.reset();
     midCutFilter.reset();
-    dcBlockerX1 = 0.0f;
-    dcBlockerY1 = 0.0f;
+
+    for (auto& antialiaser : stageAntialiasers)
+        antialiaser.reset();
+
+    outputAntialiaser.reset();
+    std::fill(dcBlockers.begin(), dcBlockers.end(), DcBlockerState {});
+
+    for (auto& group : couplingStates)
+        group.fill(CouplingState {});
 }
 
 void BigMuff::processBlock(juce::AudioBuffer<float>& buffer)
@@ -52,111 +99,206 @@ void BigMuff::processBlock(juce::AudioBuffer<float>& buffer)
     if (bypassed)
         return;
 
-    const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-
-    // Update parameters
-    float currentSustain = sustain;
-    float currentTone = tone;
-    float currentVolume = volume;
+    // Only the prepared channels have filter state and tone stack buffers
+    jassert(buffer.getNumChannels() <= numChannels);
+    const auto block = juce::dsp::AudioBlock<float>(buffer)
+                           .getSubsetChannelBlock(0, static_cast<size_t>(juce::jmin(buffer.getNumChannels(), numChannels)));
 
-    // Sustain controls overall gain (1x to 100x for massive sustain)
-    float gainAmount = 1.0f + (currentSustain * 99.0f);
-    
-    // Tone control adjusts the balance between bass and treble (mid always scooped)
-    float bassAmount = 0.3f + (1.0f - currentTone) * 0.7f;
-    float trebleAmount = 0.3f + currentTone * 0.7f;
-
-    for (int ch = 0; ch < numChannels; ++ch)
+    // Switching order clears the clippers' history, so only touch it when a parameter moved
+    if (consumeParameterChanges())
     {
-        float* channelData = buffer.getWritePointer(ch);
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            float sample = channelData[i];
+        for (auto& antialiaser : stageAntialiasers)
+            antialiaser.setOrder(antialiasing);
 
-            // Input filter - remove DC and low rumble
-            sample = inputFilter.processSample(sample, ch);
+        outputAntialiaser.setOrder(antialiasing);
+        sustainGain.setTargetValue(getSustainGain(sustain));
+        volumeGain.setTargetValue(volume);
+    }
 
-            // First gain stage
-            sample *= gainAmount * 0.5f;
-            sample = clipStage(sample, 0.6f);
+    // Hosts may exceed the prepared block size; the tone stack buffers only hold that much
+    const size_t chunkSize = static_cast<size_t>(trebleBuffer.getNumSamples());
 
-            // Second gain stage
-            sample *= 2.0f;
-            sample = clipStage(sample, 0.5f);
+    for (size_t start = 0; start < block.getNumSamples(); start += chunkSize)
+        processChunk(block.getSubBlock(start, juce::jmin(chunkSize, block.getNumSamples() - start)));
+}
 
-            // Third gain stage (more clipping = more sustain)
-            sample *= 1.5f;
-            sample = clipStage(sample, 0.4f);
+void BigMuff::processChunk(const juce::dsp::AudioBlock<float>& block)
+{
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const int blockChannels = static_cast<int>(block.getNumChannels());
 
-            // Fourth gain stage (final saturation)
-            sample *= 1.3f;
-            sample = clipStage(sample, 0.35f);
+    // Tone control adjusts the balance between bass and treble (mid always scooped)
+    float bassAmount = 0.3f + (1.0f - tone) * 0.7f;
+    float trebleAmount = 0.3f + tone * 0.7f;
+
+    // Input filter - remove DC and low rumble
+    inputFilter.processBlock(block);
+
+    // Four gain stages, each followed by its clipper. The first carries the sustain,
+    // later ones add more clipping (more sustain), the fourth is the final saturation.
+    // The sustain ramps, so the first stage's gain is applied ahead of the stage loop.
+    sustainGain.applyGain(block);
+    const std::array<float, 4> stageGains { 1.0f, 2.0f, 1.5f, 1.3f };
+
+    if (outputAntialiaser.getOrder() == AntialiasedWaveshaper::Order::None)
+        processGainStages<false>(block, stageGains);
+    else
+        processGainStages<true>(block, stageGains);
+
+    // Tone stack - this is where the magic happens
+    // Split into bass and treble, scoop the mids (bass is filtered in place)
+    auto treble = juce::dsp::AudioBlock<float>(trebleBuffer).getSubsetChannelBlock(0, static_cast<size_t>(blockChannels))
+                                                            .getSubBlock(0, static_cast<size_t>(numSamples));
+    auto mid = juce::dsp::AudioBlock<float>(midBuffer).getSubsetChannelBlock(0, static_cast<size_t>(blockChannels))
+                                                      .getSubBlock(0, static_cast<size_t>(numSamples));
+    const auto& bass = block;
+
+    treble.copyFrom(bass);
+    mid.copyFrom(bass);
+    lowPassFilter.processBlock(bass);
+    highPassFilter.processBlock(treble);
+    midCutFilter.processBlock(mid);
+
+    for (int ch = 0; ch < blockChannels; ++ch)
+    {
+        float* channelData = block.getChannelPointer(static_cast<size_t>(ch));
+        const float* trebleData = treble.getChannelPointer(static_cast<size_t>(ch));
+        const float* midData = mid.getChannelPointer(static_cast<size_t>(ch));
+        auto& dcBlocker = dcBlockers[static_cast<size_t>(ch)];
 
-            // Tone stack - this is where the magic happens
-            // Split into bass and treble, scoop the mids
-            float bass = lowPassFilter.processSample(sample, ch);
-            float treble = highPassFilter.processSample(sample, ch);
-            float mid = midCutFilter.processSample(sample, ch);
-            
+        for (int i = 0; i < numSamples; ++i)
+        {
             // Mix with mid scoop
-            sample = (bass * bassAmount + treble * trebleAmount - mid * 0.4f);
+            float sample = (channelData[i] * bassAmount + trebleData[i] * trebleAmount - midData[i] * 0.4f);
 
             // DC blocker
-            float dcOut = sample - dcBlockerX1 + 0.995f * dcBlockerY1;
-            dcBlockerX1 = sample;
-            dcBlockerY1 = dcOut;
+            float dcOut = sample - dcBlocker.x1 + 0.995f * dcBlocker.y1;
+            dcBlocker.x1 = sample;
+            dcBlocker.y1 = dcOut;
             sample = dcOut;
 
-            // Output volume
-            sample *= currentVolume;
+            channelData[i] = sample;
+        }
+    }
 
-            // Final soft clip to prevent harsh peaks
-            if (sample > 0.9f)
-                sample = 0.9f + 0.1f * std::tanh((sample - 0.9f) * 5.0f);
-            else if (sample < -0.9f)
-                sample = -0.9f + 0.1f * std::tanh((sample + 0.9f) * 5.0f);
+    // Output volume
+    volumeGain.applyGain(block);
 
-            channelData[i] = sample;
+    // Final soft clip to prevent harsh peaks
+    outputAntialiaser.processBlock(block);
+}
+
+template <bool useAntialiasing>
+void BigMuff::processGainStages(const juce::dsp::AudioBlock<float>& block, const std::array<float, 4>& stageGains) noexcept
+{
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const int blockChannels = static_cast<int>(block.getNumChannels());
+
+    // Channels go through in groups of laneCount, one per lane, so every lane loop below
+    // is one vector operation. Unused lanes carry silence and are never stored.
+    for (int firstChannel = 0; firstChannel < blockChannels; firstChannel += laneCount)
+    {
+        const int lanes = juce::jmin(laneCount, blockChannels - firstChannel);
+        auto& couplings = couplingStates[static_cast<size_t>(firstChannel / laneCount)];
+        std::array<float*, laneCount> data {};
+
+        for (int lane = 0; lane < lanes; ++lane)
+            data[static_cast<size_t>(lane)] = block.getChannelPointer(static_cast<size_t>(firstChannel + lane));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            Lanes x {};
+
+            for (int lane = 0; lane < lanes; ++lane)
+                x[static_cast<size_t>(lane)] = data[static_cast<size_t>(lane)][i];
+
+            for (size_t stage = 0; stage < stageGains.size(); ++stage)
+            {
+                for (size_t lane = 0; lane < laneCount; ++lane)
+                    x[lane] *= stageGains[stage];
+
+                // ADAA keeps history per channel, so it only runs the lanes in use
+                if constexpr (useAntialiasing)
+                {
+                    for (int lane = 0; lane < lanes; ++lane)
+                        x[static_cast<size_t>(lane)] = stageAntialiasers[stage].processSample(x[static_cast<size_t>(lane)], firstChannel + lane);
+                }
+                else
+                {
+                    for (size_t lane = 0; lane < laneCount; ++lane)
+                        x[lane] = stageClippers[stage].processSample(x[lane]);
+                }
+
+                if (stage >= numCouplings)
+                    continue;
+
+                // Coupling capacitor high-pass, then the next stage's feedback capacitor low-pass
+                auto& state = couplings[stage];
+                const float highPass = highPassCoefficients[stage];
+                const float lowPass = lowPassCoefficients[stage];
+
+                for (size_t lane = 0; lane < laneCount; ++lane)
+                {
+                    const float coupled = highPass * (state.highPassY1[lane] + x[lane] - state.highPassX1[lane]);
+                    state.highPassX1[lane] = x[lane];
+                    state.highPassY1[lane] = coupled;
+                    state.lowPassY1[lane] += lowPass * (coupled - state.lowPassY1[lane]);
+                    x[lane] = state.lowPassY1[lane];
+                }
+            }
+
+            for (int lane = 0; lane < lanes; ++lane)
+                data[static_cast<size_t>(lane)][i] = x[static_cast<size_t>(lane)];
         }
     }
 }
 
+float BigMuff::outputClip(float sample)
+{
+    // Soft clip above 0.9 (the excesses are zero below it)
+    const float posExcess = juce::jmax(sample - 0.9f, 0.0f);
+    const float negExcess = juce::jmax(-sample - 0.9f, 0.0f);
+
+    return juce::jlimit(-0.9f, 0.9f, sample)
+         + 0.1f * (FastMath::tanh(posExcess * 5.0f) - FastMath::tanh(negExcess * 5.0f));
+}
+
 float BigMuff::clipStage(float sample, float threshold)
 {
     // Asymmetric soft clipping for each stage
     // This creates the thick, saturated Big Muff sound
+    const float headroom = 1.0f - threshold;
+    const float scale = 1.0f / headroom;
     
-    if (sample > threshold)
-    {
-        // Soft clip positive
-        float excess = sample - threshold;
-        sample = threshold + (1.0f - threshold) * std::tanh(excess / (1.0f - threshold));
-    }
-    else if (sample < -threshold)
-    {
-        // Slightly different negative clipping (asymmetry adds harmonics)
-        float excess = -sample - threshold;
-        sample = -(threshold + (1.0f - threshold) * std::tanh(excess / (1.0f - threshold) * 0.9f));
-    }
+    // Branch-free: at most one excess is non-zero, and both are zero inside the threshold
+    const float posExcess = juce::jmax(sample - threshold, 0.0f);
+    const float negExcess = juce::jmax(-sample - threshold, 0.0f);
+
+    // Soft clip positive; slightly different negative clipping (asymmetry adds harmonics)
+    sample = juce::jlimit(-threshold, threshold, sample)
+           + headroom * (FastMath::tanh(posExcess * scale) - FastMath::tanh(negExcess * scale * 0.9f));
     
     return sample * 0.8f; // Compensate for clipping gain
 }
 
 void BigMuff::setSustain(float newSustain)
 {
-    sustain = juce::jlimit(0.0f, 1.0f, newSustain);
+    updateParameter(sustain, juce::jlimit(0.0f, 1.0f, newSustain));
 }
 
 void BigMuff::setTone(float newTone)
 {
-    tone = juce::jlimit(0.0f, 1.0f, newTone);
+    updateParameter(tone, juce::jlimit(0.0f, 1.0f, newTone));
 }
 
 void BigMuff::setVolume(float newVolume)
 {
-    volume = juce::jlimit(0.0f, 1.0f, newVolume);
+    updateParameter(volume, juce::jlimit(0.0f, 1.0f, newVolume));
+}
+
+void BigMuff::setAntialiasing(AntialiasedWaveshaper::Order newOrder)
+{
+    updateParameter(antialiasing, newOrder);
 }
 
 std::unique_ptr<juce::XmlElement> BigMuff::getStateInformation() const
@@ -165,6 +307,7 @@ std::unique_ptr<juce::XmlElement> BigMuff::getStateInformation() const
     xml->setAttribute("sustain", sustain);
     xml->setAttribute("tone", tone);
     xml->setAttribute("volume", volume);
+    xml->setAttribute("quality", static_cast<int>(antialiasing));
     xml->setAttribute("bypassed", bypassed);
     return xml;
 }
@@ -176,39 +319,46 @@ void BigMuff::setStateInformation(const juce::XmlElement& xml)
         sustain = static_cast<float>(xml.getDoubleAttribute("sustain", 0.7));
         tone = static_cast<float>(xml.getDoubleAttribute("tone", 0.5));
         volume = static_cast<float>(xml.getDoubleAttribute("volume", 0.7));
+        antialiasing = static_cast<AntialiasedWaveshaper::Order>(juce::jlimit(0, 2, xml.getIntAttribute("quality", 0)));
         bypassed = xml.getBoolAttribute("bypassed", false);
+        markParametersChanged();
     }
 }
 
-void BigMuff::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                                     const juce::String& prefix)
+const std::vector<EffectBase::ParameterInfo>& BigMuff::getParameterInfo() const
 {
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "sustain",
-        "Sustain",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.7f,
-        ""));
+    // Order must match ParameterIndex
+    static const std::vector<ParameterInfo> parameters
+    {
+        { "sustain", "Sustain", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f },
+        { "tone",    "Tone",    juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f },
+        { "volume",  "Volume",  juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f },
+        { "quality", "Quality (Standard/ADAA/ADAA2)", juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f }
+    };
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "tone",
-        "Tone",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f,
-        ""));
+    return parameters;
+}
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "volume",
-        "Volume",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.7f,
-        ""));
+void BigMuff::setParameter(int index, float value)
+{
+    switch (index)
+    {
+        case sustainIndex: setSustain(value); break;
+        case toneIndex: setTone(value); break;
+        case volumeIndex: setVolume(value); break;
+        case qualityIndex: setAntialiasing(static_cast<AntialiasedWaveshaper::Order>(juce::jlimit(0, 2, juce::roundToInt(value)))); break;
+        default: break;
+    }
 }
 
-void BigMuff::linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                             const juce::String& prefix)
+float BigMuff::getParameter(int index) const
 {
-    sustainParam = apvts.getRawParameterValue(prefix + "sustain");
-    toneParam = apvts.getRawParameterValue(prefix + "tone");
-    volumeParam = apvts.getRawParameterValue(prefix + "volume");
+    switch (index)
+    {
+        case sustainIndex: return sustain;
+        case toneIndex: return tone;
+        case volumeIndex: return volume;
+        case qualityIndex: return static_cast<float>(static_cast<int>(antialiasing));
+        default: return 0.0f;
+    }
 }
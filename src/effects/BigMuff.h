@@ -2,12 +2,25 @@
 
 #include "EffectBase.h"
 #include "../dsp/Filter.h"
+#include "../dsp/Waveshaper.h"
+#include "../dsp/AntialiasedWaveshaper.h"
+#include <array>
+#include <vector>
 #include <juce_audio_processors/juce_audio_processors.h>
 
 /**
  * Big Muff-style fuzz/distortion pedal.
  * Iconic Pink Floyd sound with thick, creamy, sustaining distortion.
  * Features mid-scooped tone and massive sustain.
+ *
+ * The four gain stages have one-pole coupling filters between them as in the
+ * circuit: the coupling capacitor's high-pass and the next stage's feedback
+ * capacitor's low-pass. The stage loop advances all channels together, one
+ * channel per lane, so the recursive filters vectorize too.
+ *
+ * The pedal does no oversampling of its own. In the Pedal Board it runs
+ * inside the chain's oversampling (see EffectChain::setOversampling()), and
+ * prepare() is given that rate.
  */
 class BigMuff : public EffectBase
 {
@@ -19,6 +32,7 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     void processBlock(juce::AudioBuffer<float>& buffer) override;
+    bool runsAtOversampledRate() const override { return true; }
 
     // Metadata
     juce::String getName() const override { return "Big Muff"; }
@@ -28,42 +42,93 @@ public:
     std::unique_ptr<juce::XmlElement> getStateInformation() const override;
     void setStateInformation(const juce::XmlElement& xml) override;
 
-    // Parameter layout for APVTS
-    void addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                               const juce::String& prefix) override;
-    void linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                       const juce::String& prefix) override;
+    // Parameter binding
+    enum ParameterIndex { sustainIndex = 0, toneIndex, volumeIndex, qualityIndex };
+    const std::vector<ParameterInfo>& getParameterInfo() const override;
+    void setParameter(int index, float value) override;
+    float getParameter(int index) const override;
 
     // Parameter setters
     void setSustain(float newSustain);
     void setTone(float newTone);
     void setVolume(float newVolume);
 
-private:
-    // Parameters
-    std::atomic<float>* sustainParam = nullptr;
-    std::atomic<float>* toneParam = nullptr;
-    std::atomic<float>* volumeParam = nullptr;
+    /** Order::None is the standard quality; First and Second clip every stage with ADAA. */
+    void setAntialiasing(AntialiasedWaveshaper::Order newOrder);
 
+private:
     // Cached parameter values
     float sustain = 0.7f;   // Gain/sustain control
     float tone = 0.5f;      // Tone control (mid scoop)
     float volume = 0.7f;    // Output volume
+    AntialiasedWaveshaper::Order antialiasing = AntialiasedWaveshaper::Order::None;
+
+    // Ramped per sample: the first gain stage, which carries the sustain, and the output volume
+    SmoothedParameter sustainGain { 35.15f };
+    SmoothedParameter volumeGain { 0.7f };
+
+    // Sustain knob to the first stage's gain (1x to 100x for massive sustain, halved into the stage)
+    static float getSustainGain(float sustainValue) { return (1.0f + sustainValue * 99.0f) * 0.5f; }
 
     // Multi-stage clipping for thick fuzz
-    float clipStage(float sample, float threshold);
+    static float clipStage(float sample, float threshold);
+    static float outputClip(float sample);
+
+    // The clipping curves sampled into tables, one per gain stage, plus the output soft clip
+    static constexpr std::array<float, 4> stageThresholds { 0.6f, 0.5f, 0.4f, 0.35f };
+    std::array<Waveshaper, 4> stageClippers;
+    Waveshaper outputClipper;
+
+    // Every clip runs through these, which add ADAA in the ADAA qualities
+    std::array<AntialiasedWaveshaper, 4> stageAntialiasers;
+    AntialiasedWaveshaper outputAntialiaser;
+    static constexpr float clipperInputLimit = 8.0f;   // Every curve has flattened out by here
     
+    // Processes at most samplesPerBlock samples, the size of the tone stack buffers
+    void processChunk(const juce::dsp::AudioBlock<float>& block);
+
+    // Channels processed together by the gain stage loop: one SSE/NEON register of floats
+    static constexpr int laneCount = 4;
+    using Lanes = std::array<float, laneCount>;
+    static constexpr int numCouplings = 3;   // Between the four gain stages
+
+    /** Coupling filter state of one group of channels, one channel per lane. */
+    struct CouplingState
+    {
+        Lanes highPassX1 {}, highPassY1 {}, lowPassY1 {};
+    };
+
+    // The four gain stages with their clippers and coupling filters
+    template <bool useAntialiasing>
+    void processGainStages(const juce::dsp::AudioBlock<float>& block, const std::array<float, 4>& stageGains) noexcept;
+
+    // Coupling filters: one-pole coefficients per coupling at the prepared rate, state per group of laneCount channels
+    static constexpr float couplingHighPassHz = 30.0f;
+    static constexpr std::array<float, numCouplings> couplingLowPassHz { 8000.0f, 6500.0f, 5000.0f };
+    std::array<float, numCouplings> highPassCoefficients {};
+    std::array<float, numCouplings> lowPassCoefficients {};
+    std::vector<std::array<CouplingState, numCouplings>> couplingStates;
+
     // Tone stack filters (mid-scoop characteristic)
     SimpleFilter lowPassFilter;
     SimpleFilter highPassFilter;
     SimpleFilter midCutFilter;
+
+    // Treble and mid bands of the tone stack, split from the clipped signal
+    juce::AudioBuffer<float> trebleBuffer;
+    juce::AudioBuffer<float> midBuffer;
     
     // Input filtering
     SimpleFilter inputFilter;
     
-    // DC blocking
-    float dcBlockerX1 = 0.0f;
-    float dcBlockerY1 = 0.0f;
+    // DC blocking, per channel
+    struct DcBlockerState
+    {
+        float x1 = 0.0f;
+        float y1 = 0.0f;
+    };
+
+    std::vector<DcBlockerState> dcBlockers;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BigMuff)
 };
@@ -18,6 +18,11 @@ void Chorus::prepare(double sampleRate, int samplesPerBlock)
     delayBufferSize = static_cast<int>(sampleRate * maxDelayMs / 1000.0) + 1;
     delayBuffer.setSize(2, delayBufferSize);
     
+    smoothedDepth.prepare(sampleRate, samplesPerBlock);
+    smoothedDepth.setCurrentAndTargetValue(depth);
+    smoothedMix.prepare(sampleRate, samplesPerBlock);
+    smoothedMix.setCurrentAndTargetValue(mix);
+
     reset();
 }
 
@@ -28,6 +33,12 @@ void Chorus::reset()
     lfoPhase = 0.0f;
 }
 
+int Chorus::getTailSamples() const
+{
+    // The longest a sample can stay in the delay line
+    return delayBufferSize;
+}
+
 void Chorus::processBlock(juce::AudioBuffer<float>& buffer)
 {
     if (bypassed)
@@ -36,14 +47,29 @@ void Chorus::processBlock(juce::AudioBuffer<float>& buffer)
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
 
+    // Depth and mix ramp per sample when they move
+    if (consumeParameterChanges())
+    {
+        smoothedDepth.setTargetValue(depth);
+        smoothedMix.setTargetValue(mix);
+    }
+
+    const float* depths = smoothedDepth.getRamp(numSamples);
+    const float* mixes = smoothedMix.getRamp(numSamples);
+    const float steadyDepth = smoothedDepth.getCurrentValue();
+    const float steadyMix = smoothedMix.getCurrentValue();
+
     for (int sample = 0; sample < numSamples; ++sample)
     {
+        const float currentDepth = depths != nullptr ? depths[sample] : steadyDepth;
+        const float currentMix = mixes != nullptr ? mixes[sample] : steadyMix;
+
         // Calculate LFO value (0.0 to 1.0)
         float lfoValue = calculateLFO();
         
         // Calculate delay time in samples (5ms to 30ms modulated by LFO)
         float baseDelayMs = 15.0f;
-        float modulationMs = 15.0f * depth;
+        float modulationMs = 15.0f * currentDepth;
         float currentDelayMs = baseDelayMs + (lfoValue * modulationMs);
         float delaySamples = (currentDelayMs / 1000.0f) * static_cast<float>(sampleRate);
 
@@ -70,7 +96,7 @@ void Chorus::processBlock(juce::AudioBuffer<float>& buffer)
             float delayedSample = delayed1 + fraction * (delayed2 - delayed1);
             
             // Mix dry and wet signals
-            float output = input * (1.0f - mix) + delayedSample * mix;
+            float output = input * (1.0f - currentMix) + delayedSample * currentMix;
             
             buffer.setSample(channel, sample, output);
         }
@@ -101,12 +127,12 @@ void Chorus::setRate(float newRate)
 
 void Chorus::setDepth(float newDepth)
 {
-    depth = juce::jlimit(0.0f, 1.0f, newDepth);
+    updateParameter(depth, juce::jlimit(0.0f, 1.0f, newDepth));
 }
 
 void Chorus::setMix(float newMix)
 {
-    mix = juce::jlimit(0.0f, 1.0f, newMix);
+    updateParameter(mix, juce::jlimit(0.0f, 1.0f, newMix));
 }
 
 std::unique_ptr<juce::XmlElement> Chorus::getStateInformation() const
@@ -127,41 +153,43 @@ void Chorus::setStateInformation(const juce::XmlElement& xml)
         depth = static_cast<float>(xml.getDoubleAttribute("depth", 0.5));
         mix = static_cast<float>(xml.getDoubleAttribute("mix", 0.5));
         bypassed = xml.getBoolAttribute("bypassed", false);
+        markParametersChanged();
     }
 }
 
-void Chorus::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                                    const juce::String& prefix)
+const std::vector<EffectBase::ParameterInfo>& Chorus::getParameterInfo() const
 {
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "rate",
-        "Rate",
-        juce::NormalisableRange<float>(0.1f, 5.0f, 0.01f),
-        1.5f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "depth",
-        "Depth",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f));
+    // Order must match ParameterIndex
+    static const std::vector<ParameterInfo> parameters
+    {
+        { "rate",  "Rate",  juce::NormalisableRange<float>(0.1f, 5.0f, 0.01f), 1.5f },
+        { "depth", "Depth", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f },
+        { "mix",   "Mix",   juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f }
+    };
     
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "mix",
-        "Mix",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f));
-}
-
-void Chorus::linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                            const juce::String& prefix)
-{
-    // Link parameters from APVTS to internal values
-    if (auto* rateParam = apvts.getRawParameterValue(prefix + "rate"))
-        rate = *rateParam;
-    if (auto* depthParam = apvts.getRawParameterValue(prefix + "depth"))
-        depth = *depthParam;
-    if (auto* mixParam = apvts.getRawParameterValue(prefix + "mix"))
-        mix = *mixParam;
+    return parameters;
+}
+
+void Chorus::setParameter(int index, float value)
+{
+    switch (index)
+    {
+        case rateIndex: setRate(value); break;
+        case depthIndex: setDepth(value); break;
+        case mixIndex: setMix(value); break;
+        default: break;
+    }
+}
+
+float Chorus::getParameter(int index) const
+{
+    switch (index)
+    {
+        case rateIndex: return rate;
+        case depthIndex: return depth;
+        case mixIndex: return mix;
+        default: return 0.0f;
+    }
 }
 
 void Chorus::updateParameters()
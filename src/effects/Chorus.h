@@ -14,6 +14,7 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     void processBlock(juce::AudioBuffer<float>& buffer) override;
+    int getTailSamples() const override;
 
     // Metadata
     juce::String getName() const override { return "Chorus"; }
@@ -23,11 +24,11 @@ public:
     std::unique_ptr<juce::XmlElement> getStateInformation() const override;
     void setStateInformation(const juce::XmlElement& xml) override;
 
-    // Parameter layout for APVTS
-    void addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                               const juce::String& prefix) override;
-    void linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                       const juce::String& prefix) override;
+    // Parameter binding
+    enum ParameterIndex { rateIndex = 0, depthIndex, mixIndex };
+    const std::vector<ParameterInfo>& getParameterInfo() const override;
+    void setParameter(int index, float value) override;
+    float getParameter(int index) const override;
 
     // Parameter setters
     void setRate(float newRate);
@@ -45,6 +46,10 @@ private:
     float depth = 0.5f;     // Modulation depth (0.0 - 1.0)
     float mix = 0.5f;       // Wet/dry mix (0.0 - 1.0)
 
+    // Per-sample ramps of depth and mix
+    SmoothedParameter smoothedDepth { 0.5f };
+    SmoothedParameter smoothedMix { 0.5f };
+
     // DSP components
     static constexpr int maxDelayMs = 50;
     juce::AudioBuffer<float> delayBuffer;
@@ -1,4 +1,5 @@
 #include "Compressor.h"
+#include "../dsp/FastMath.h"
 
 Compressor::Compressor()
 {
@@ -11,7 +12,9 @@ Compressor::~Compressor()
 void Compressor::prepare(double newSampleRate, int samplesPerBlock)
 {
     sampleRate = newSampleRate;
-    updateCoefficients();
+    makeupGainLinear.prepare(sampleRate, samplesPerBlock);
+    makeupGainLinear.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(makeupGain));
+    markParametersChanged();
     reset();
 }
 
@@ -27,8 +30,8 @@ void Compressor::processBlock(juce::AudioBuffer<float>& buffer)
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
     
-    // Convert makeup gain from dB to linear
-    const float makeupGainLinear = juce::Decibels::decibelsToGain(makeupGain);
+    if (consumeParameterChanges())
+        updateCoefficients();
     
     for (int channel = 0; channel < numChannels; ++channel)
     {
@@ -38,11 +41,9 @@ void Compressor::processBlock(juce::AudioBuffer<float>& buffer)
         {
             float inputSample = channelData[sample];
             
-            // Convert to dB for processing
+            // Convert to dB for processing (levels below -100 dB read as -100 dB)
             float inputLevel = std::abs(inputSample);
-            float inputDb = inputLevel > 0.00001f 
-                ? juce::Decibels::gainToDecibels(inputLevel)
-                : -100.0f;
+            float inputDb = FastMath::gainToDecibels(inputLevel, -100.0f);
             
             // Envelope follower
             float envelope = envelopeFollower[channel];
@@ -70,12 +71,15 @@ void Compressor::processBlock(juce::AudioBuffer<float>& buffer)
             currentGainReduction = gainReductionDb;
             
             // Convert gain reduction to linear and apply
-            float gainLinear = juce::Decibels::decibelsToGain(-gainReductionDb);
+            float gainLinear = FastMath::decibelsToGain(-gainReductionDb);
             
-            // Apply compression and makeup gain
-            channelData[sample] = inputSample * gainLinear * makeupGainLinear;
+            // Apply compression
+            channelData[sample] = inputSample * gainLinear;
         }
     }
+
+    // Apply makeup gain, ramping when it moves
+    makeupGainLinear.applyGain(juce::dsp::AudioBlock<float>(buffer));
 }
 
 void Compressor::setThreshold(float thresholdDb)
@@ -90,19 +94,17 @@ void Compressor::setRatio(float newRatio)
 
 void Compressor::setAttack(float attackMs)
 {
-    attack = juce::jlimit(0.1f, 100.0f, attackMs);
-    updateCoefficients();
+    updateParameter(attack, juce::jlimit(0.1f, 100.0f, attackMs));
 }
 
 void Compressor::setRelease(float releaseMs)
 {
-    release = juce::jlimit(10.0f, 1000.0f, releaseMs);
-    updateCoefficients();
+    updateParameter(release, juce::jlimit(10.0f, 1000.0f, releaseMs));
 }
 
 void Compressor::setMakeupGain(float gainDb)
 {
-    makeupGain = juce::jlimit(0.0f, 24.0f, gainDb);
+    updateParameter(makeupGain, juce::jlimit(0.0f, 24.0f, gainDb));
 }
 
 void Compressor::updateCoefficients()
@@ -111,6 +113,9 @@ void Compressor::updateCoefficients()
     // Using exponential averaging
     attackCoeff = std::exp(-1.0f / (attack * 0.001f * static_cast<float>(sampleRate)));
     releaseCoeff = std::exp(-1.0f / (release * 0.001f * static_cast<float>(sampleRate)));
+
+    // Convert makeup gain from dB to linear
+    makeupGainLinear.setTargetValue(juce::Decibels::decibelsToGain(makeupGain));
 }
 
 std::unique_ptr<juce::XmlElement> Compressor::getStateInformation() const
@@ -135,68 +140,47 @@ void Compressor::setStateInformation(const juce::XmlElement& xml)
         release = static_cast<float>(xml.getDoubleAttribute("release", 100.0));
         makeupGain = static_cast<float>(xml.getDoubleAttribute("makeupGain", 0.0));
         bypassed = xml.getBoolAttribute("bypassed", false);
-        updateCoefficients();
+        markParametersChanged();
     }
 }
 
-void Compressor::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                                        const juce::String& prefix)
+const std::vector<EffectBase::ParameterInfo>& Compressor::getParameterInfo() const
 {
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "threshold",
-        "Threshold",
-        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f),
-        -20.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "ratio",
-        "Ratio",
-        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f),
-        4.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "attack",
-        "Attack",
-        juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f),
-        10.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "release",
-        "Release",
-        juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f),
-        100.0f));
+    // Order must match ParameterIndex
+    static const std::vector<ParameterInfo> parameters
+    {
+        { "threshold",  "Threshold",   juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -20.0f },
+        { "ratio",      "Ratio",       juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 4.0f },
+        { "attack",     "Attack",      juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f), 10.0f },
+        { "release",    "Release",     juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f), 100.0f },
+        { "makeupGain", "Makeup Gain", juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f), 0.0f }
+    };
     
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "makeupGain",
-        "Makeup Gain",
-        juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f),
-        0.0f));
+    return parameters;
 }
 
-void Compressor::linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                                const juce::String& prefix)
+void Compressor::setParameter(int index, float value)
 {
-    // Link parameters from APVTS to internal values
-    if (auto* thresholdParam = apvts.getRawParameterValue(prefix + "threshold"))
+    switch (index)
     {
-        threshold = *thresholdParam;
+        case thresholdIndex: setThreshold(value); break;
+        case ratioIndex: setRatio(value); break;
+        case attackIndex: setAttack(value); break;
+        case releaseIndex: setRelease(value); break;
+        case makeupGainIndex: setMakeupGain(value); break;
+        default: break;
     }
-    if (auto* ratioParam = apvts.getRawParameterValue(prefix + "ratio"))
-    {
-        ratio = *ratioParam;
-    }
-    if (auto* attackParam = apvts.getRawParameterValue(prefix + "attack"))
-    {
-        attack = *attackParam;
-        updateCoefficients();
-    }
-    if (auto* releaseParam = apvts.getRawParameterValue(prefix + "release"))
-    {
-        release = *releaseParam;
-        updateCoefficients();
-    }
-    if (auto* makeupParam = apvts.getRawParameterValue(prefix + "makeupGain"))
+}
+
+float Compressor::getParameter(int index) const
+{
+    switch (index)
     {
-        makeupGain = *makeupParam;
+        case thresholdIndex: return threshold;
+        case ratioIndex: return ratio;
+        case attackIndex: return attack;
+        case releaseIndex: return release;
+        case makeupGainIndex: return makeupGain;
+        default: return 0.0f;
     }
 }
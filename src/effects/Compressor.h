@@ -21,10 +21,10 @@ public:
     std::unique_ptr<juce::XmlElement> getStateInformation() const override;
     void setStateInformation(const juce::XmlElement& xml) override;
     
-    void addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                               const juce::String& prefix) override;
-    void linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                       const juce::String& prefix) override;
+    enum ParameterIndex { thresholdIndex = 0, ratioIndex, attackIndex, releaseIndex, makeupGainIndex };
+    const std::vector<ParameterInfo>& getParameterInfo() const override;
+    void setParameter(int index, float value) override;
+    float getParameter(int index) const override;
 
     // Parameter setters
     void setThreshold(float thresholdDb);
@@ -50,10 +50,11 @@ private:
     double sampleRate = 44100.0;
     float attackCoeff = 0.0f;
     float releaseCoeff = 0.0f;
+    SmoothedParameter makeupGainLinear { 1.0f };
     float envelopeFollower[2] = { 0.0f, 0.0f };
     float currentGainReduction = 0.0f;
 
-    void updateCoefficients();
+    void updateCoefficients();   // Audio thread, after consumeParameterChanges()
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Compressor)
 };
@@ -1,4 +1,33 @@
 #include "EffectBase.h"
 
-// EffectBase is a pure abstract class, so there are no implementations here.
-// All methods must be implemented by derived classes.
+const std::vector<EffectBase::ParameterInfo>& EffectBase::getParameterInfo() const
+{
+    // Effects without automatable parameters (e.g., the tuner)
+    static const std::vector<ParameterInfo> noParameters;
+    return noParameters;
+}
+
+void EffectBase::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
+                                       const juce::String& prefix)
+{
+    for (const auto& info : getParameterInfo())
+    {
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            prefix + info.id,
+            info.name,
+            info.range,
+            info.defaultValue));
+    }
+}
+
+void EffectBase::linkParameters(juce::AudioProcessorValueTreeState& apvts,
+                                const juce::String& prefix)
+{
+    const auto& parameters = getParameterInfo();
+
+    for (int i = 0; i < static_cast<int>(parameters.size()); ++i)
+    {
+        if (auto* param = apvts.getRawParameterValue(prefix + parameters[static_cast<size_t>(i)].id))
+            setParameter(i, param->load());
+    }
+}
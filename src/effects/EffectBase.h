@@ -3,11 +3,18 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+#include "../dsp/SmoothedParameter.h"
 
 /**
  * Abstract base class for all guitar effects in the OpenGuitar plugin.
  * Provides a unified interface for effect processing, parameter management,
  * and state serialization to enable flexible effect chaining in the Pedal Board.
+ *
+ * Parameters that act directly on the signal (gains, mixes, depths) should
+ * go through a SmoothedParameter so automation ramps instead of stepping at
+ * block boundaries.
  */
 class EffectBase
 {
@@ -37,6 +44,80 @@ public:
      * @param buffer The audio buffer to process (modified in-place)
      */
     virtual void processBlock(juce::AudioBuffer<float>& buffer) = 0;
+
+    /**
+     * Processes part of a buffer in place, for hosts of the effect that split
+     * blocks (e.g. to apply automation between sub-blocks). The effect sees a
+     * buffer referring to the same channel data, so nothing is copied and,
+     * for up to 32 channels, nothing is allocated.
+     * @param buffer The whole audio buffer
+     * @param startSample The first sample to process
+     * @param numSamples The number of samples to process
+     */
+    void processRange(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+    {
+        if (startSample == 0 && numSamples == buffer.getNumSamples())
+        {
+            processBlock(buffer);
+            return;
+        }
+
+        juce::AudioBuffer<float> range(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                                       startSample, numSamples);
+        processBlock(range);
+    }
+
+    /**
+     * Sets how many channels processBlock() will be given.
+     * Takes effect at the next prepare(), which sizes per-channel state to match.
+     * @param newNumChannels The number of channels to prepare for
+     */
+    void setNumChannels(int newNumChannels) noexcept { numChannels = juce::jmax(1, newNumChannels); }
+
+    /**
+     * Returns the number of channels the effect prepares for.
+     */
+    int getNumChannels() const noexcept { return numChannels; }
+
+    //==============================================================================
+    // Oversampling
+
+    /**
+     * Returns true for effects whose processing should run oversampled, such as
+     * drive pedals. A host can oversample a run of such effects once for all of
+     * them instead of each effect converting on its own (see setHostOversampled()).
+     */
+    virtual bool runsAtOversampledRate() const { return false; }
+
+    /**
+     * Tells the effect whether its host does the oversampling around it.
+     * Takes effect at the next prepare(), whose sample rate and block size are
+     * then already the oversampled ones; the effect must not oversample again.
+     * @param shouldBeHostOversampled True if the host resamples around the effect
+     */
+    void setHostOversampled(bool shouldBeHostOversampled) noexcept { hostOversampled = shouldBeHostOversampled; }
+
+    /**
+     * Returns whether the effect is prepared to be oversampled by its host.
+     */
+    bool isHostOversampled() const noexcept { return hostOversampled; }
+
+    //==============================================================================
+    // Latency and Tail
+
+    /**
+     * Returns the delay the effect adds to the signal, in samples at the rate it
+     * was prepared for. An effect with a mix control must delay its dry signal by
+     * the same amount before blending (see DelayCompensator).
+     * Called from both the message and the audio thread, so it must be real-time safe.
+     */
+    virtual int getLatencySamples() const { return 0; }
+
+    /**
+     * Returns how long the output keeps sounding after the input falls silent,
+     * in samples at the rate the effect was prepared for.
+     */
+    virtual int getTailSamples() const { return 0; }
     
     //==============================================================================
     // Bypass Control
@@ -51,6 +132,26 @@ public:
      * Returns whether the effect is currently bypassed.
      */
     virtual bool isBypassed() const { return bypassed; }
+
+    //==============================================================================
+    // Observers
+
+    /**
+     * Registers interest in the effect's analysis results (e.g. a tuner display).
+     * Analysis effects only run their detection while at least one observer is
+     * registered. Every call must be balanced by removeObserver().
+     */
+    void addObserver() noexcept { ++observerCount; }
+
+    /**
+     * Withdraws interest registered with addObserver().
+     */
+    void removeObserver() noexcept { --observerCount; }
+
+    /**
+     * Returns whether anyone is currently observing the effect. Safe from any thread.
+     */
+    bool isObserved() const noexcept { return observerCount.load(std::memory_order_relaxed) > 0; }
     
     //==============================================================================
     // Metadata
@@ -84,30 +185,101 @@ public:
     //==============================================================================
     // Parameter Management
     
+    /**
+     * Describes one automatable parameter of an effect.
+     */
+    struct ParameterInfo
+    {
+        juce::String id;                        // Unprefixed parameter ID (e.g., "gain")
+        juce::String name;                      // Display name (e.g., "Gain")
+        juce::NormalisableRange<float> range;   // Range in the effect's own units
+        float defaultValue;
+    };
+
+    /**
+     * Returns the effect's automatable parameters.
+     * The position of each entry is the index passed to setParameter().
+     */
+    virtual const std::vector<ParameterInfo>& getParameterInfo() const;
+
+    /**
+     * Sets a parameter by its index in getParameterInfo().
+     * Called from the audio thread, and only when the value has actually changed.
+     * @param index The parameter index
+     * @param value The new value, in the range given by getParameterInfo()
+     */
+    virtual void setParameter(int index, float value) {}
+
+    /**
+     * Returns the current value of a parameter by its index in getParameterInfo().
+     * @param index The parameter index
+     * @return The value, in the range given by getParameterInfo()
+     */
+    virtual float getParameter(int index) const { return 0.0f; }
+
     /**
      * Adds this effect's parameters to a parameter layout.
      * Used when building the APVTS for the Pedal Board plugin.
+     * The default implementation adds one float parameter per getParameterInfo() entry.
      * @param layout The parameter layout to add parameters to
      * @param prefix A prefix for parameter IDs (e.g., "effect1_" for the first effect)
      */
     virtual void addParametersToLayout(
         juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-        const juce::String& prefix) = 0;
+        const juce::String& prefix);
     
     /**
-     * Links this effect's internal parameters to APVTS parameters.
-     * Called after the APVTS is created to establish parameter connections.
+     * Copies the current APVTS values into this effect's parameters.
+     * The Pedal Board binds parameters through its chain snapshot instead; this
+     * is for driving a single effect directly from an APVTS.
      * @param apvts The AudioProcessorValueTreeState containing the parameters
      * @param prefix The prefix used when adding parameters (must match addParametersToLayout)
      */
     virtual void linkParameters(
         juce::AudioProcessorValueTreeState& apvts,
-        const juce::String& prefix) = 0;
+        const juce::String& prefix);
     
 protected:
     bool bypassed = false;
     double sampleRate = 44100.0;
     int samplesPerBlock = 512;
+    int numChannels = 2;
+    bool hostOversampled = false;
     
+    /**
+     * Stores a parameter value and, only if it actually moved, flags the
+     * coefficients derived from it as stale.
+     * @param parameter The member holding the parameter
+     * @param newValue The value to store
+     * @return True if the value changed
+     */
+    template <typename ValueType>
+    bool updateParameter(ValueType& parameter, ValueType newValue) noexcept
+    {
+        if (parameter == newValue)
+            return false;
+
+        parameter = newValue;
+        markParametersChanged();
+        return true;
+    }
+
+    /**
+     * Flags derived coefficients as stale without changing a parameter,
+     * e.g. after the sample rate changed.
+     */
+    void markParametersChanged() noexcept { parametersChanged.store(true, std::memory_order_release); }
+
+    /**
+     * Returns true once for every batch of parameter changes. Effects call this at
+     * the start of processBlock() and only recompute coefficients when it is true,
+     * so static knobs cost nothing per block. Starts out true.
+     */
+    bool consumeParameterChanges() noexcept { return parametersChanged.exchange(false, std::memory_order_acq_rel); }
+
+private:
+    std::atomic<int> observerCount { 0 };
+    std::atomic<bool> parametersChanged { true };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectBase)
 };
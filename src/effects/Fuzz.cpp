@@ -1,93 +1,256 @@
 #include "Fuzz.h"
+#include "../dsp/FastMath.h"
 
 Fuzz::Fuzz()
-    : oversampling(2, oversampleFactor, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR)
 {
+    clipper.build(asymmetricClip, clipperInputLimit);
+    antialiasedClipper.setShaper(clipper);
 }
 
 Fuzz::~Fuzz()
 {
+    stopTimer();
+    delete pendingEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
 }
 
 void Fuzz::prepare(double newSampleRate, int samplesPerBlock)
 {
+    // Anything the timer built for the old settings is stale now
+    stopTimer();
+    delete pendingEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
+
     sampleRate = newSampleRate;
+    preparedBlockSize = samplesPerBlock;
     
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate * oversampleFactor;
-    spec.maximumBlockSize = samplesPerBlock * oversampleFactor;
-    spec.numChannels = 2;
-    
-    oversampling.initProcessing(samplesPerBlock);
-    
-    preFilter.setSampleRate(spec.sampleRate);
+    preFilter.setNumChannels(numChannels);
     preFilter.setType(SimpleFilter::FilterType::LowPass);
     preFilter.setCutoff(2000.0f);
     
-    toneFilter.setSampleRate(spec.sampleRate);
-    toneFilter.setType(SimpleFilter::FilterType::LowPass);
+    toneFilter.setNumChannels(numChannels);
+    toneFilter.setOutputType(StateVariableFilter::OutputType::LowPass);
+
+    antialiasedClipper.setNumChannels(numChannels);
+
+    // Sized for the highest oversampling, the largest block the smoothers can see
+    const int maxOversampledBlockSize = samplesPerBlock << maxOversamplingStages;
+    gainMultiplier.prepare(sampleRate, maxOversampledBlockSize);
+    outputGain.prepare(sampleRate, maxOversampledBlockSize);
+
+    // Build the requested oversampling here, then let the timer rebuild it when the setting moves
+    builtStages = getRequestedStages();
+    builtFilter = oversamplingFilter.load();
+    engine = createEngine(builtStages, builtFilter);
+    installedLatency = engine->latencySamples;
+    reportedLatency = engine->latencySamples;
+
+    // Sets every processing rate and the tone table, then snap to the current settings
+    installEngine();
+    antialiasedClipper.setOrder(antialiasing);
+    toneFilter.setControl(tone);
+    toneFilter.reset();
+    gainMultiplier.setCurrentAndTargetValue(getGainMultiplier(gain));
+    outputGain.setCurrentAndTargetValue(level * 0.5f);
+
+    startTimer(engineCheckIntervalMs);
 }
 
 void Fuzz::reset()
 {
-    oversampling.reset();
+    if (engine != nullptr && engine->oversampling != nullptr)
+        engine->oversampling->reset();
+
     preFilter.reset();
     toneFilter.reset();
+    antialiasedClipper.reset();
 }
 
 void Fuzz::processBlock(juce::AudioBuffer<float>& buffer)
 {
-    auto block = juce::dsp::AudioBlock<float>(buffer);
-    auto oversampledBlock = oversampling.processSamplesUp(block);
-    
-    // Update tone filter cutoff based on tone parameter
-    float cutoffFreq = 300.0f + (tone * 4700.0f); // 300Hz to 5kHz
-    toneFilter.setCutoff(cutoffFreq);
+    updateEngine();
+
+    if (consumeParameterChanges())
+    {
+        antialiasedClipper.setOrder(antialiasing);
+
+        // Update tone filter cutoff based on tone parameter (glides to it)
+        toneFilter.setControl(tone);
     
-    // Calculate actual gain multiplier (logarithmic scaling for more musical response)
-    float gainMultiplier = std::pow(10.0f, gain * 0.4f - 1.0f); // Ranges from ~0.1 to ~25
+        gainMultiplier.setTargetValue(getGainMultiplier(gain));
+        outputGain.setTargetValue(level * 0.5f);
+    }
     
-    for (int channel = 0; channel < oversampledBlock.getNumChannels(); ++channel)
+    auto* oversampling = engine->oversampling.get();
+    auto block = juce::dsp::AudioBlock<float>(buffer);
+    auto processingBlock = oversampling != nullptr ? oversampling->processSamplesUp(block) : block;
+
+    // Pre-filter to shape input (reduce high frequency before distortion)
+    preFilter.processBlock(processingBlock);
+
+    // Apply gain boost, then asymmetric clipping for vintage fuzz character
+    if (antialiasedClipper.getOrder() == AntialiasedWaveshaper::Order::None)
     {
-        auto* channelData = oversampledBlock.getChannelPointer(channel);
-        
-        for (size_t sample = 0; sample < oversampledBlock.getNumSamples(); ++sample)
+        const auto* gains = gainMultiplier.getRamp(static_cast<int>(processingBlock.getNumSamples()));
+        const float steadyGain = gainMultiplier.getCurrentValue();
+
+        for (size_t channel = 0; channel < processingBlock.getNumChannels(); ++channel)
         {
-            float inputSample = channelData[sample];
-            
-            // Pre-filter to shape input (reduce high frequency before distortion)
-            inputSample = preFilter.processSample(inputSample, channel);
-            
-            // Apply gain boost
-            inputSample *= gainMultiplier;
-            
-            // Asymmetric clipping for vintage fuzz character
-            inputSample = asymmetricClip(inputSample);
-            
-            // Tone control (post-distortion filtering)
-            inputSample = toneFilter.processSample(inputSample, channel);
-            
-            // Output level compensation
-            channelData[sample] = inputSample * level * 0.5f;
+            auto* channelData = processingBlock.getChannelPointer(channel);
+
+            if (gains != nullptr)
+            {
+                for (size_t sample = 0; sample < processingBlock.getNumSamples(); ++sample)
+                    channelData[sample] = clipper.processSample(channelData[sample] * gains[sample]);
+            }
+            else
+            {
+                for (size_t sample = 0; sample < processingBlock.getNumSamples(); ++sample)
+                    channelData[sample] = clipper.processSample(channelData[sample] * steadyGain);
+            }
         }
     }
+    else
+    {
+        gainMultiplier.applyGain(processingBlock);
+        antialiasedClipper.processBlock(processingBlock);
+    }
+
+    // Tone control (post-distortion filtering)
+    toneFilter.processBlock(processingBlock);
+
+    // Output level compensation
+    outputGain.applyGain(processingBlock);
     
-    oversampling.processSamplesDown(block);
+    if (oversampling != nullptr)
+        oversampling->processSamplesDown(block);
+}
+
+std::unique_ptr<Fuzz::Engine> Fuzz::createEngine(int stages, OversamplingFilter filter) const
+{
+    auto newEngine = std::make_unique<Engine>();
+    newEngine->rate = sampleRate * static_cast<double>(1 << stages);
+
+    if (stages > 0)
+    {
+        newEngine->oversampling = std::make_unique<Oversampler>(static_cast<size_t>(numChannels),
+                                                                static_cast<size_t>(stages), filter);
+        newEngine->oversampling->initProcessing(static_cast<size_t>(preparedBlockSize));
+        newEngine->latencySamples = newEngine->oversampling->getLatencyInSamples();
+    }
+
+    // Tone knob to filter coefficients, sampled once for this rate
+    newEngine->toneTable.build(toneTableSize, [rate = newEngine->rate](float toneValue)
+    {
+        return StateVariableFilter::makeCoefficients(getToneCutoff(toneValue), 0.707f, rate);
+    });
+
+    return newEngine;
+}
+
+void Fuzz::installEngine()
+{
+    const double rate = engine->rate;
+
+    preFilter.setSampleRate(rate);
+    preFilter.reset();
+
+    toneFilter.setSampleRate(rate);
+    toneFilter.setControlTable(&engine->toneTable);
+    toneFilter.reset();
+
+    gainMultiplier.setSampleRate(rate);
+    outputGain.setSampleRate(rate);
+
+    antialiasedClipper.reset();
+
+    if (engine->oversampling != nullptr)
+        engine->oversampling->reset();
+}
+
+void Fuzz::updateEngine()
+{
+    // Only swap once the timer has collected the previous engine, so there is always room to retire this one
+    auto* next = pendingEngine.load(std::memory_order_acquire);
+
+    if (next == nullptr || retiredEngine.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    pendingEngine.store(nullptr, std::memory_order_relaxed);
+    retiredEngine.store(engine.release(), std::memory_order_release);
+    engine.reset(next);
+    installEngine();
+    installedLatency.store(engine->latencySamples, std::memory_order_release);
+}
+
+void Fuzz::timerCallback()
+{
+    // Free whatever the audio thread has swapped out
+    delete retiredEngine.exchange(nullptr, std::memory_order_acquire);
+
+    // Only report latency once the engine it belongs to is running
+    const int latency = installedLatency.load(std::memory_order_acquire);
+
+    if (latency != reportedLatency)
+    {
+        reportedLatency = latency;
+
+        if (onLatencyChange != nullptr)
+            onLatencyChange(latency);
+    }
+
+    const int stages = getRequestedStages();
+    const auto filter = oversamplingFilter.load();
+
+    // One engine in flight at a time; a newer request is picked up on a later tick
+    if (pendingEngine.load(std::memory_order_acquire) != nullptr || (stages == builtStages && filter == builtFilter))
+        return;
+
+    auto newEngine = createEngine(stages, filter);
+    builtStages = stages;
+    builtFilter = filter;
+    pendingEngine.store(newEngine.release(), std::memory_order_release);
 }
 
 void Fuzz::setGain(float newGain)
 {
-    gain = newGain;
+    updateParameter(gain, newGain);
 }
 
 void Fuzz::setTone(float newTone)
 {
-    tone = juce::jlimit(0.0f, 1.0f, newTone);
+    updateParameter(tone, juce::jlimit(0.0f, 1.0f, newTone));
 }
 
 void Fuzz::setLevel(float newLevel)
 {
-    level = juce::jlimit(0.0f, 1.0f, newLevel);
+    updateParameter(level, juce::jlimit(0.0f, 1.0f, newLevel));
+}
+
+void Fuzz::setAntialiasing(AntialiasedWaveshaper::Order newOrder)
+{
+    updateParameter(antialiasing, newOrder);
+}
+
+void Fuzz::setOversampling(int numStages)
+{
+    oversamplingStages.store(juce::jlimit(0, maxOversamplingStages, numStages));
+}
+
+void Fuzz::setOversamplingFilter(OversamplingFilter newFilter)
+{
+    oversamplingFilter.store(newFilter);
+}
+
+float Fuzz::getToneCutoff(float toneValue)
+{
+    return 300.0f + (toneValue * 4700.0f); // 300Hz to 5kHz
+}
+
+float Fuzz::getGainMultiplier(float gainValue)
+{
+    // Logarithmic scaling for more musical response
+    return std::pow(10.0f, gainValue * 0.4f - 1.0f); // Ranges from ~0.1 to ~25
 }
 
 float Fuzz::asymmetricClip(float sample)
@@ -97,26 +260,19 @@ float Fuzz::asymmetricClip(float sample)
     const float posThreshold = 0.3f;
     const float negThreshold = 0.25f;
     
-    if (sample > posThreshold)
-    {
-        // Soft clip positive
-        float excess = sample - posThreshold;
-        sample = posThreshold + excess / (1.0f + excess * excess);
-    }
-    else if (sample < -negThreshold)
-    {
-        // Harder clip negative for asymmetric character
-        float excess = -(sample + negThreshold);
-        sample = -negThreshold - excess / (1.0f + excess * excess * 1.5f);
-    }
-    
-    // Apply soft saturation to everything for warmth
-    sample = std::tanh(sample * 1.5f) * 0.8f;
+    // Written without branches so the oversampled loop vectorizes: at most one
+    // excess is non-zero, and it is zero inside the thresholds
+    const float posExcess = juce::jmax(sample - posThreshold, 0.0f);
+    const float negExcess = juce::jmax(-(sample + negThreshold), 0.0f);
     
-    // Final hard limiting
-    sample = juce::jlimit(-1.0f, 1.0f, sample);
+    // Soft clip positive, harder clip negative for asymmetric character
+    sample = juce::jlimit(-negThreshold, posThreshold, sample)
+           + posExcess / (1.0f + posExcess * posExcess)
+           - negExcess / (1.0f + negExcess * negExcess * 1.5f);
     
-    return sample;
+    // Apply soft saturation to everything for warmth. The result stays
+    // within +-0.8, so no final limiting is needed.
+    return FastMath::tanh(sample * 1.5f) * 0.8f;
 }
 
 std::unique_ptr<juce::XmlElement> Fuzz::getStateInformation() const
@@ -125,6 +281,9 @@ std::unique_ptr<juce::XmlElement> Fuzz::getStateInformation() const
     xml->setAttribute("gain", gain);
     xml->setAttribute("tone", tone);
     xml->setAttribute("level", level);
+    xml->setAttribute("quality", static_cast<int>(antialiasing));
+    xml->setAttribute("oversampling", oversamplingStages.load());
+    xml->setAttribute("oversamplingFilter", static_cast<int>(oversamplingFilter.load()));
     xml->setAttribute("bypassed", bypassed);
     return xml;
 }
@@ -136,46 +295,56 @@ void Fuzz::setStateInformation(const juce::XmlElement& xml)
         gain = static_cast<float>(xml.getDoubleAttribute("gain", 5.0));
         tone = static_cast<float>(xml.getDoubleAttribute("tone", 0.5));
         level = static_cast<float>(xml.getDoubleAttribute("level", 0.7));
+        antialiasing = static_cast<AntialiasedWaveshaper::Order>(juce::jlimit(0, 2, xml.getIntAttribute("quality", 0)));
+        setOversampling(xml.getIntAttribute("oversampling", 1));
+        setOversamplingFilter(static_cast<OversamplingFilter>(juce::jlimit(0, 2, xml.getIntAttribute("oversamplingFilter", 0))));
         bypassed = xml.getBoolAttribute("bypassed", false);
+        markParametersChanged();
     }
 }
 
-void Fuzz::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                                  const juce::String& prefix)
+const std::vector<EffectBase::ParameterInfo>& Fuzz::getParameterInfo() const
 {
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "gain",
-        "Gain",
-        juce::NormalisableRange<float>(0.0f, 10.0f, 0.1f),
-        5.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "tone",
-        "Tone",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f));
+    // Order must match ParameterIndex. The oversampling pair has no effect while host oversampled.
+    static const std::vector<ParameterInfo> parameters
+    {
+        { "gain",  "Gain",  juce::NormalisableRange<float>(0.0f, 10.0f, 0.1f), 5.0f },
+        { "tone",  "Tone",  juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f },
+        { "level", "Level", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f },
+        { "quality", "Quality (Standard/ADAA/ADAA2)", juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f },
+        { "oversampling", "Oversampling (Off/2x/4x/8x/16x)",
+          juce::NormalisableRange<float>(0.0f, static_cast<float>(maxOversamplingStages), 1.0f), 1.0f },
+        { "oversamplingFilter", "Oversampling Filter (IIR/Linear Phase/Minimum Phase)",
+          juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f }
+    };
     
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "level",
-        "Level",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.7f));
+    return parameters;
 }
 
-void Fuzz::linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                          const juce::String& prefix)
+void Fuzz::setParameter(int index, float value)
 {
-    // Link parameters from APVTS to internal values
-    if (auto* gainParam = apvts.getRawParameterValue(prefix + "gain"))
+    switch (index)
     {
-        gain = *gainParam;
+        case gainIndex: setGain(value); break;
+        case toneIndex: setTone(value); break;
+        case levelIndex: setLevel(value); break;
+        case qualityIndex: setAntialiasing(static_cast<AntialiasedWaveshaper::Order>(juce::jlimit(0, 2, juce::roundToInt(value)))); break;
+        case oversamplingIndex: setOversampling(juce::roundToInt(value)); break;
+        case oversamplingFilterIndex: setOversamplingFilter(static_cast<OversamplingFilter>(juce::jlimit(0, 2, juce::roundToInt(value)))); break;
+        default: break;
     }
-    if (auto* toneParam = apvts.getRawParameterValue(prefix + "tone"))
-    {
-        tone = *toneParam;
-    }
-    if (auto* levelParam = apvts.getRawParameterValue(prefix + "level"))
+}
+
+float Fuzz::getParameter(int index) const
+{
+    switch (index)
     {
-        level = *levelParam;
+        case gainIndex: return gain;
+        case toneIndex: return tone;
+        case levelIndex: return level;
+        case qualityIndex: return static_cast<float>(static_cast<int>(antialiasing));
+        case oversamplingIndex: return static_cast<float>(oversamplingStages.load());
+        case oversamplingFilterIndex: return static_cast<float>(static_cast<int>(oversamplingFilter.load()));
+        default: return 0.0f;
     }
 }
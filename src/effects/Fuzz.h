@@ -2,12 +2,32 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
 #include "../dsp/Filter.h"
+#include "../dsp/StateVariableFilter.h"
+#include "../dsp/Waveshaper.h"
+#include "../dsp/AntialiasedWaveshaper.h"
+#include "../dsp/Oversampler.h"
 #include "EffectBase.h"
 
-class Fuzz : public EffectBase
+/**
+ * Fuzz pedal: pre-filter, gain into an asymmetric clipper, then a tone filter,
+ * all run at an oversampled rate.
+ *
+ * The oversampling factor (off to 16x) and its filters (IIR, linear-phase FIR
+ * or minimum-phase) are parameters. Changing them needs a new Oversampler and
+ * tone table, which a timer builds on the message
+ * thread and hands to the audio thread through an atomic pointer. The audio
+ * thread swaps the new engine in at the start of a block and hands the old one
+ * back the same way for deletion, so it never allocates or frees.
+ */
+class Fuzz : public EffectBase,
+             private juce::Timer
 {
 public:
+    using OversamplingFilter = Oversampler::FilterType;
+
     Fuzz();
     ~Fuzz() override;
 
@@ -22,33 +42,106 @@ public:
     std::unique_ptr<juce::XmlElement> getStateInformation() const override;
     void setStateInformation(const juce::XmlElement& xml) override;
     
-    void addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                               const juce::String& prefix) override;
-    void linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                       const juce::String& prefix) override;
+    enum ParameterIndex { gainIndex = 0, toneIndex, levelIndex, qualityIndex, oversamplingIndex, oversamplingFilterIndex };
+    const std::vector<ParameterInfo>& getParameterInfo() const override;
+    void setParameter(int index, float value) override;
+    float getParameter(int index) const override;
 
     // Parameter setters
     void setGain(float newGain);
     void setTone(float newTone);
     void setLevel(float newLevel);
 
+    bool runsAtOversampledRate() const override { return true; }
+
+    /** Order::None is the standard quality; First and Second clip with ADAA at the processing rate. */
+    void setAntialiasing(AntialiasedWaveshaper::Order newOrder);
+
+    /**
+     * Sets the oversampling as a number of 2x stages: 0 is off, 4 is 16x.
+     * Real-time safe; the new oversampling is built off the audio thread and
+     * takes effect a timer tick or so later. Ignored while host oversampled,
+     * which in the Pedal Board is whenever the board's oversampling is on. The
+     * same goes for setOversamplingFilter().
+     */
+    void setOversampling(int numStages);
+    void setOversamplingFilter(OversamplingFilter newFilter);
+
+    /** The latency of the oversampling the audio thread is running, in host-rate samples. */
+    int getLatencySamples() const noexcept override { return installedLatency.load(); }
+
+    /**
+     * Called on the message thread once a rebuilt oversampling with a different
+     * latency has gone live, for the processor to report it to the host.
+     */
+    std::function<void(int)> onLatencyChange;
+
+    static constexpr int maxOversamplingStages = 4;
+
 private:
+    /** Everything that depends on the oversampling rate and has to be allocated. */
+    struct Engine
+    {
+        std::unique_ptr<Oversampler> oversampling;                      // Null when oversampling is off
+        StateVariableFilter::ControlTable toneTable;                    // At this engine's rate
+        double rate = 44100.0;
+        int latencySamples = 0;
+    };
+
+    // Builds an engine for the prepared rate and channels (allocates; not the audio thread)
+    std::unique_ptr<Engine> createEngine(int stages, OversamplingFilter filter) const;
+
+    // Audio thread: retunes the filters and smoothers to the current engine
+    void installEngine();
+
+    // Audio thread: swaps in a pending engine, if there is one and the retire slot is free
+    void updateEngine();
+
+    void timerCallback() override;
+
+    // The stages to build: none when the host already oversamples around the fuzz
+    int getRequestedStages() const noexcept { return isHostOversampled() ? 0 : oversamplingStages.load(); }
+
     float processSample(float sample);
-    float asymmetricClip(float sample);
+    static float asymmetricClip(float sample);   // Transfer curve of clipper
+    static float getToneCutoff(float toneValue);
+    static float getGainMultiplier(float gainValue);
 
     // Parameters
     float gain = 5.0f;
     float tone = 0.5f;
     float level = 0.7f;
+    AntialiasedWaveshaper::Order antialiasing = AntialiasedWaveshaper::Order::None;
+    std::atomic<int> oversamplingStages { 1 };
+    std::atomic<OversamplingFilter> oversamplingFilter { OversamplingFilter::IIR };
+
+    // Ramped per sample at the processing rate
+    SmoothedParameter gainMultiplier { 1.0f };
+    SmoothedParameter outputGain { 0.35f };
 
     // DSP
     double sampleRate = 44100.0;
     SimpleFilter preFilter;
-    SimpleFilter toneFilter;
+    Waveshaper clipper;   // asymmetricClip() sampled into a table
+    AntialiasedWaveshaper antialiasedClipper;   // The same curve with ADAA, for the ADAA qualities
+    static constexpr float clipperInputLimit = 32.0f;   // Past the highest gain's peaks
+    StateVariableFilter toneFilter;   // Glides between tone settings
+    static constexpr int toneTableSize = 128;
     
-    // Oversampling
-    static constexpr int oversampleFactor = 2;
-    juce::dsp::Oversampling<float> oversampling;
+    // Oversampling engine in use (audio thread), one built and waiting, and one swapped out for deletion
+    std::unique_ptr<Engine> engine;
+    std::atomic<Engine*> pendingEngine { nullptr };
+    std::atomic<Engine*> retiredEngine { nullptr };
+
+    // What the last engine was built for (message thread)
+    int builtStages = 1;
+    OversamplingFilter builtFilter = OversamplingFilter::IIR;
+
+    // Latency of the engine in use, set when the audio thread installs it, and as last reported
+    std::atomic<int> installedLatency { 0 };
+    int reportedLatency = 0;
+    int preparedBlockSize = 512;
+    static constexpr int engineCheckIntervalMs = 50;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Fuzz)
 };
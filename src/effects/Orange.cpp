@@ -1,8 +1,12 @@
 #include "Orange.h"
+#include "../dsp/FastMath.h"
 #include <cmath>
 
 Orange::Orange()
 {
+    // The curve hard clips at +-1, so the table only needs to reach a little past it
+    softClipper.build(softClip, 2.0f);
+    softClipAntialiaser.setShaper(softClipper);
 }
 
 Orange::~Orange()
@@ -14,15 +18,38 @@ void Orange::prepare(double sampleRate, int samplesPerBlock)
     this->sampleRate = sampleRate;
     this->samplesPerBlock = samplesPerBlock;
 
+    // Tone control to cutoff: warm high-end rolloff and tight low-end, sampled once for this rate
+    lowPassTable.build(toneTableSize, [sampleRate](float toneValue)
+    {
+        return StateVariableFilter::makeCoefficients(1000.0f + (toneValue * 4500.0f), 0.707f, sampleRate); // 1kHz to 5.5kHz
+    });
+    highPassTable.build(toneTableSize, [sampleRate](float toneValue)
+    {
+        return StateVariableFilter::makeCoefficients(50.0f + ((1.0f - toneValue) * 150.0f), 0.707f, sampleRate); // 50Hz to 200Hz
+    });
+
     // Setup tone filters
-    lowPassFilter.setType(SimpleFilter::FilterType::LowPass);
+    lowPassFilter.setNumChannels(numChannels);
+    lowPassFilter.setOutputType(StateVariableFilter::OutputType::LowPass);
     lowPassFilter.setSampleRate(sampleRate);
-    lowPassFilter.setCutoff(3500.0f); // Warm, smooth high-end rolloff
+    lowPassFilter.setControlTable(&lowPassTable);
 
-    highPassFilter.setType(SimpleFilter::FilterType::HighPass);
+    highPassFilter.setNumChannels(numChannels);
+    highPassFilter.setOutputType(StateVariableFilter::OutputType::HighPass);
     highPassFilter.setSampleRate(sampleRate);
-    highPassFilter.setCutoff(80.0f); // Tight low-end
+    highPassFilter.setControlTable(&highPassTable);
+
+    softClipAntialiaser.setNumChannels(numChannels);
+    softClipAntialiaser.setOrder(antialiasing);
 
+    driveGain.prepare(sampleRate, samplesPerBlock);
+    outputLevel.prepare(sampleRate, samplesPerBlock);
+    driveGain.setCurrentAndTargetValue(getDriveAmount(gain));
+    outputLevel.setCurrentAndTargetValue(level);
+
+    // Start at the tone setting; reset() jumps straight there
+    lowPassFilter.setControl(tone);
+    highPassFilter.setControl(tone);
     reset();
 }
 
@@ -30,6 +57,7 @@ void Orange::reset()
 {
     lowPassFilter.reset();
     highPassFilter.reset();
+    softClipAntialiaser.reset();
     dcBlockerX1 = 0.0f;
     dcBlockerY1 = 0.0f;
 }
@@ -40,23 +68,29 @@ void Orange::processBlock(juce::AudioBuffer<float>& buffer)
         return;
 
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+    jassert(buffer.getNumChannels() <= numChannels);
+    const int blockChannels = juce::jmin(buffer.getNumChannels(), numChannels);
 
-    // Update parameters
-    float currentGain = gain;
-    float currentTone = tone;
-    float currentLevel = level;
+    // Update tone filter cutoff based on tone control, only when it moved; gain and level glide
+    if (consumeParameterChanges())
+    {
+        lowPassFilter.setControl(tone);
+        highPassFilter.setControl(tone);
+        softClipAntialiaser.setOrder(antialiasing);
+        driveGain.setTargetValue(getDriveAmount(gain));
+        outputLevel.setTargetValue(level);
+    }
 
-    // Calculate gain scaling (0-10 style, Orange amps go to 11 in spirit!)
-    float driveAmount = 1.0f + (currentGain * 19.0f); // 1x to 20x gain
-    
-    // Update tone filter cutoff based on tone control
-    float lpFreq = 1000.0f + (currentTone * 4500.0f); // 1kHz to 5.5kHz
-    float hpFreq = 50.0f + ((1.0f - currentTone) * 150.0f); // 50Hz to 200Hz
-    lowPassFilter.setCutoff(lpFreq);
-    highPassFilter.setCutoff(hpFreq);
+    // Pre-gain stage (simulates input stage), then British-style asymmetric soft clipping
+    auto block = juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(0, static_cast<size_t>(blockChannels));
+    driveGain.applyGain(block);
+    softClipAntialiaser.processBlock(block);
+
+    // Tone stack (pre-emphasis and post-filtering)
+    highPassFilter.processBlock(block);
+    lowPassFilter.processBlock(block);
 
-    for (int ch = 0; ch < numChannels; ++ch)
+    for (int ch = 0; ch < blockChannels; ++ch)
     {
         float* channelData = buffer.getWritePointer(ch);
 
@@ -64,28 +98,18 @@ void Orange::processBlock(juce::AudioBuffer<float>& buffer)
         {
             float sample = channelData[i];
 
-            // Pre-gain stage (simulates input stage)
-            sample *= driveAmount;
-
-            // British-style asymmetric soft clipping
-            sample = softClip(sample);
-
-            // Tone stack (pre-emphasis and post-filtering)
-            sample = highPassFilter.processSample(sample, ch);
-            sample = lowPassFilter.processSample(sample, ch);
-
             // DC blocker
             float dcOut = sample - dcBlockerX1 + 0.995f * dcBlockerY1;
             dcBlockerX1 = sample;
             dcBlockerY1 = dcOut;
             sample = dcOut;
 
-            // Output level control
-            sample *= currentLevel;
-
             channelData[i] = sample;
         }
     }
+
+    // Output level control
+    outputLevel.applyGain(block);
 }
 
 float Orange::softClip(float sample)
@@ -101,7 +125,7 @@ float Orange::softClip(float sample)
     else if (sample > 0.33f)
     {
         // Soft clip positive
-        sample = 0.33f + (2.0f / 3.0f) * (1.0f - std::exp(-1.5f * (sample - 0.33f)));
+        sample = 0.33f + (2.0f / 3.0f) * (1.0f - FastMath::exp(-1.5f * (sample - 0.33f)));
     }
     else if (sample < -1.0f)
     {
@@ -111,7 +135,7 @@ float Orange::softClip(float sample)
     else if (sample < -0.33f)
     {
         // Soft clip negative (slightly different curve for asymmetry)
-        sample = -0.33f - (2.0f / 3.0f) * (1.0f - std::exp(-1.3f * (-sample - 0.33f)));
+        sample = -0.33f - (2.0f / 3.0f) * (1.0f - FastMath::exp(-1.3f * (-sample - 0.33f)));
     }
     
     return sample * 0.6f; // Compensate for clipping gain
@@ -119,17 +143,22 @@ float Orange::softClip(float sample)
 
 void Orange::setGain(float newGain)
 {
-    gain = juce::jlimit(0.0f, 1.0f, newGain);
+    updateParameter(gain, juce::jlimit(0.0f, 1.0f, newGain));
 }
 
 void Orange::setTone(float newTone)
 {
-    tone = juce::jlimit(0.0f, 1.0f, newTone);
+    updateParameter(tone, juce::jlimit(0.0f, 1.0f, newTone));
 }
 
 void Orange::setLevel(float newLevel)
 {
-    level = juce::jlimit(0.0f, 1.0f, newLevel);
+    updateParameter(level, juce::jlimit(0.0f, 1.0f, newLevel));
+}
+
+void Orange::setAntialiasing(AntialiasedWaveshaper::Order newOrder)
+{
+    updateParameter(antialiasing, newOrder);
 }
 
 std::unique_ptr<juce::XmlElement> Orange::getStateInformation() const
@@ -138,6 +167,7 @@ std::unique_ptr<juce::XmlElement> Orange::getStateInformation() const
     xml->setAttribute("gain", gain);
     xml->setAttribute("tone", tone);
     xml->setAttribute("level", level);
+    xml->setAttribute("quality", static_cast<int>(antialiasing));
     xml->setAttribute("bypassed", bypassed);
     return xml;
 }
@@ -149,39 +179,46 @@ void Orange::setStateInformation(const juce::XmlElement& xml)
         gain = static_cast<float>(xml.getDoubleAttribute("gain", 0.5));
         tone = static_cast<float>(xml.getDoubleAttribute("tone", 0.5));
         level = static_cast<float>(xml.getDoubleAttribute("level", 0.7));
+        antialiasing = static_cast<AntialiasedWaveshaper::Order>(juce::jlimit(0, 2, xml.getIntAttribute("quality", 0)));
         bypassed = xml.getBoolAttribute("bypassed", false);
+        markParametersChanged();
     }
 }
 
-void Orange::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                                    const juce::String& prefix)
+const std::vector<EffectBase::ParameterInfo>& Orange::getParameterInfo() const
 {
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "gain",
-        "Gain",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f,
-        ""));
-
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "tone",
-        "Tone",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f,
-        ""));
-
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "level",
-        "Level",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.7f,
-        ""));
+    // Order must match ParameterIndex
+    static const std::vector<ParameterInfo> parameters
+    {
+        { "gain",  "Gain",  juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f },
+        { "tone",  "Tone",  juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f },
+        { "level", "Level", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f },
+        { "quality", "Quality (Standard/ADAA/ADAA2)", juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f }
+    };
+
+    return parameters;
 }
 
-void Orange::linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                            const juce::String& prefix)
+void Orange::setParameter(int index, float value)
 {
-    gainParam = apvts.getRawParameterValue(prefix + "gain");
-    toneParam = apvts.getRawParameterValue(prefix + "tone");
-    levelParam = apvts.getRawParameterValue(prefix + "level");
+    switch (index)
+    {
+        case gainIndex: setGain(value); break;
+        case toneIndex: setTone(value); break;
+        case levelIndex: setLevel(value); break;
+        case qualityIndex: setAntialiasing(static_cast<AntialiasedWaveshaper::Order>(juce::jlimit(0, 2, juce::roundToInt(value)))); break;
+        default: break;
+    }
+}
+
+float Orange::getParameter(int index) const
+{
+    switch (index)
+    {
+        case gainIndex: return gain;
+        case toneIndex: return tone;
+        case levelIndex: return level;
+        case qualityIndex: return static_cast<float>(static_cast<int>(antialiasing));
+        default: return 0.0f;
+    }
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../dsp/Filter.h"
+#include "../dsp/StateVariableFilter.h"
+#include "../dsp/Waveshaper.h"
+#include "../dsp/AntialiasedWaveshaper.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 
 /**
@@ -18,6 +20,7 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     void processBlock(juce::AudioBuffer<float>& buffer) override;
+    bool runsAtOversampledRate() const override { return true; }
 
     // Metadata
     juce::String getName() const override { return "Orange"; }
@@ -27,34 +30,47 @@ public:
     std::unique_ptr<juce::XmlElement> getStateInformation() const override;
     void setStateInformation(const juce::XmlElement& xml) override;
 
-    // Parameter layout for APVTS
-    void addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                               const juce::String& prefix) override;
-    void linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                       const juce::String& prefix) override;
+    // Parameter binding
+    enum ParameterIndex { gainIndex = 0, toneIndex, levelIndex, qualityIndex };
+    const std::vector<ParameterInfo>& getParameterInfo() const override;
+    void setParameter(int index, float value) override;
+    float getParameter(int index) const override;
 
     // Parameter setters
     void setGain(float newGain);
     void setTone(float newTone);
     void setLevel(float newLevel);
 
-private:
-    // Parameters
-    std::atomic<float>* gainParam = nullptr;
-    std::atomic<float>* toneParam = nullptr;
-    std::atomic<float>* levelParam = nullptr;
+    /** Order::None is the standard quality; First and Second clip with ADAA. */
+    void setAntialiasing(AntialiasedWaveshaper::Order newOrder);
 
+private:
     // Cached parameter values
     float gain = 0.5f;
     float tone = 0.5f;
     float level = 0.7f;
+    AntialiasedWaveshaper::Order antialiasing = AntialiasedWaveshaper::Order::None;
+
+    // Ramped per sample: the pre-gain into the clipper and the output level
+    SmoothedParameter driveGain { 10.5f };
+    SmoothedParameter outputLevel { 0.7f };
+
+    // Gain knob to pre-gain (0-10 style, Orange amps go to 11 in spirit!)
+    static float getDriveAmount(float gainValue) { return 1.0f + (gainValue * 19.0f); } // 1x to 20x gain
+
+    // Tone stack filters (state-variable, so tone moves glide instead of stepping)
+    StateVariableFilter lowPassFilter;
+    StateVariableFilter highPassFilter;
 
-    // Tone stack filters
-    SimpleFilter lowPassFilter;
-    SimpleFilter highPassFilter;
+    // Tone control to coefficients for each filter, built in prepare()
+    StateVariableFilter::ControlTable lowPassTable;
+    StateVariableFilter::ControlTable highPassTable;
+    static constexpr int toneTableSize = 128;
     
-    // Soft clipping function for warm overdrive
-    float softClip(float sample);
+    // Soft clipping function for warm overdrive, sampled into softClipper
+    static float softClip(float sample);
+    Waveshaper softClipper;
+    AntialiasedWaveshaper softClipAntialiaser;   // Adds ADAA in the ADAA qualities
     
     // DC blocking filter
     float dcBlockerX1 = 0.0f;
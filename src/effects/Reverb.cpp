@@ -1,4 +1,5 @@
 #include "Reverb.h"
+#include <cmath>
 
 Reverb::Reverb()
 {
@@ -28,6 +29,17 @@ void Reverb::reset()
 
 void Reverb::processBlock(juce::AudioBuffer<float>& buffer)
 {
+    // setParameters() recomputes every comb and all-pass, so only call it when something moved
+    if (consumeParameterChanges())
+    {
+        reverbParams.roomSize = currentRoomSize;
+        reverbParams.damping = currentDamping;
+        reverbParams.wetLevel = currentWetLevel;
+        reverbParams.dryLevel = 1.0f - currentWetLevel;
+        reverbParams.width = currentWidth;
+        reverb.setParameters(reverbParams);
+    }
+
     juce::dsp::AudioBlock<float> block(buffer);
     juce::dsp::ProcessContextReplacing<float> context(block);
     reverb.process(context);
@@ -35,34 +47,36 @@ void Reverb::processBlock(juce::AudioBuffer<float>& buffer)
 
 void Reverb::setRoomSize(float roomSize)
 {
-    currentRoomSize = roomSize;
-    reverbParams.roomSize = roomSize;
-    reverb.setParameters(reverbParams);
+    updateParameter(currentRoomSize, roomSize);
 }
 
 void Reverb::setDamping(float damping)
 {
-    currentDamping = damping;
-    reverbParams.damping = damping;
-    reverb.setParameters(reverbParams);
+    updateParameter(currentDamping, damping);
 }
 
 void Reverb::setWetLevel(float wetLevel)
 {
-    currentWetLevel = wetLevel;
-    reverbParams.wetLevel = wetLevel;
-    reverbParams.dryLevel = 1.0f - wetLevel;
-    reverb.setParameters(reverbParams);
+    updateParameter(currentWetLevel, wetLevel);
 }
 
 void Reverb::setWidth(float width)
 {
-    currentWidth = width;
-    reverbParams.width = width;
-    reverb.setParameters(reverbParams);
+    updateParameter(currentWidth, width);
 }
 
 // EffectBase interface implementation
+int Reverb::getTailSamples() const
+{
+    // juce::Reverb's combs feed back by 0.7 + 0.28 * roomSize; count round trips
+    // of the longest comb (1617 samples at 44.1 kHz) until the echo is 60 dB down
+    const double feedback = 0.7 + 0.28 * static_cast<double>(juce::jlimit(0.0f, 1.0f, currentRoomSize));
+    const double roundTrips = std::log(0.001) / std::log(feedback);
+    const double longestComb = (1617.0 + 23.0) * sampleRate / 44100.0;
+
+    return static_cast<int>(std::ceil(roundTrips * longestComb));
+}
+
 void Reverb::prepare(double newSampleRate, int newSamplesPerBlock)
 {
     sampleRate = newSampleRate;
@@ -99,52 +113,40 @@ void Reverb::setStateInformation(const juce::XmlElement& xml)
     }
 }
 
-void Reverb::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                                    const juce::String& prefix)
+const std::vector<EffectBase::ParameterInfo>& Reverb::getParameterInfo() const
 {
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "roomSize",
-        "Room Size",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "damping",
-        "Damping",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "wetLevel",
-        "Wet Level",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.33f));
+    // Order must match ParameterIndex
+    static const std::vector<ParameterInfo> parameters
+    {
+        { "roomSize", "Room Size", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f },
+        { "damping",  "Damping",   juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f },
+        { "wetLevel", "Wet Level", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.33f },
+        { "width",    "Width",     juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f }
+    };
     
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        prefix + "width",
-        "Width",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        1.0f));
+    return parameters;
 }
 
-void Reverb::linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                            const juce::String& prefix)
+void Reverb::setParameter(int index, float value)
 {
-    // Link parameters from APVTS to internal values
-    if (auto* roomSizeParam = apvts.getRawParameterValue(prefix + "roomSize"))
-    {
-        setRoomSize(*roomSizeParam);
-    }
-    if (auto* dampingParam = apvts.getRawParameterValue(prefix + "damping"))
+    switch (index)
     {
-        setDamping(*dampingParam);
+        case roomSizeIndex: setRoomSize(value); break;
+        case dampingIndex: setDamping(value); break;
+        case wetLevelIndex: setWetLevel(value); break;
+        case widthIndex: setWidth(value); break;
+        default: break;
     }
-    if (auto* wetLevelParam = apvts.getRawParameterValue(prefix + "wetLevel"))
-    {
-        setWetLevel(*wetLevelParam);
-    }
-    if (auto* widthParam = apvts.getRawParameterValue(prefix + "width"))
+}
+
+float Reverb::getParameter(int index) const
+{
+    switch (index)
     {
-        setWidth(*widthParam);
+        case roomSizeIndex: return currentRoomSize;
+        case dampingIndex: return currentDamping;
+        case wetLevelIndex: return currentWetLevel;
+        case widthIndex: return currentWidth;
+        default: return 0.0f;
     }
 }
@@ -14,6 +14,7 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     void processBlock(juce::AudioBuffer<float>& buffer) override;
+    int getTailSamples() const override;
     
     juce::String getName() const override { return "Reverb"; }
     juce::String getEffectType() const override { return "reverb"; }
@@ -21,10 +22,10 @@ public:
     std::unique_ptr<juce::XmlElement> getStateInformation() const override;
     void setStateInformation(const juce::XmlElement& xml) override;
     
-    void addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                               const juce::String& prefix) override;
-    void linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                       const juce::String& prefix) override;
+    enum ParameterIndex { roomSizeIndex = 0, dampingIndex, wetLevelIndex, widthIndex };
+    const std::vector<ParameterInfo>& getParameterInfo() const override;
+    void setParameter(int index, float value) override;
+    float getParameter(int index) const override;
 
     // Legacy compatibility methods (for standalone Reverb plugin)
     void prepare(const juce::dsp::ProcessSpec& spec);
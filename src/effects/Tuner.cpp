@@ -2,35 +2,62 @@
 #include <cmath>
 
 Tuner::Tuner()
+    : juce::Thread("Tuner Analysis")
 {
-    frequencyHistory.resize(maxHistorySize, 0.0f);
 }
 
 Tuner::~Tuner()
 {
+    stopThread(1000);
 }
 
 void Tuner::prepare(double sampleRate, int samplesPerBlock)
 {
+    // The analysis thread owns the buffers, so it must be idle while they are reallocated
+    stopThread(1000);
+
     this->sampleRate = sampleRate;
     this->samplesPerBlock = samplesPerBlock;
     
-    // Allocate analysis buffer
+    // Decimate to roughly targetAnalysisSampleRate, always by 4x to 8x
+    decimationFactor = juce::jlimit(4, 8, static_cast<int>(sampleRate / targetAnalysisSampleRate));
+    analysisSampleRate = sampleRate / decimationFactor;
+
+    // Anti-aliasing: 4th order Butterworth low pass well below the decimated Nyquist
+    const float resonances[2] = { 0.5412f, 1.3066f };
+    for (int i = 0; i < 2; ++i)
+    {
+        antiAliasFilters[i].setNumChannels(1);   // Runs on the mono mix
+        antiAliasFilters[i].setSampleRate(sampleRate);
+        antiAliasFilters[i].setType(SimpleFilter::FilterType::LowPass);
+        antiAliasFilters[i].setResonance(resonances[i]);
+        antiAliasFilters[i].setCutoff(static_cast<float>(analysisSampleRate * 0.35));
+    }
+
+    // Allocate analysis buffers
     analysisBuffer.setSize(1, analysisBufferSize);
-    reset();
+    orderedBuffer.setSize(1, analysisBufferSize);
+    autocorrelation.prepare(analysisBufferSize);
+    detectionCurve.assign(static_cast<size_t>(std::ceil(analysisSampleRate / minFrequency)) + 2, 0.0f);
+
+    strobeLowpassCoefficient = 1.0f - std::exp(-juce::MathConstants<float>::twoPi * strobeBandwidthHz / static_cast<float>(analysisSampleRate));
+
+    spectrumWindow.resize(analysisBufferSize);
+    for (int i = 0; i < analysisBufferSize; ++i)
+        spectrumWindow[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / (analysisBufferSize - 1));
+    sampleFifoBuffer.assign(sampleFifoSize, 0.0f);
+    sampleFifo.reset();
+    resetRequested = false;
+    analysisIdle = false;
+    clearAnalysis();
+
+    startThread(juce::Thread::Priority::low);
 }
 
 void Tuner::reset()
 {
-    analysisBuffer.clear();
-    bufferWritePosition = 0;
-    samplesSinceLastAnalysis = 0;
-    detectedFrequency = 0.0f;
-    noteName = "--";
-    centsDeviation = 0.0f;
-    noteDetected = false;
-    std::fill(frequencyHistory.begin(), frequencyHistory.end(), 0.0f);
-    historyWriteIndex = 0;
+    // May be called while the analysis thread is running, so let it clear its own state
+    resetRequested = true;
 }
 
 void Tuner::processBlock(juce::AudioBuffer<float>& buffer)
@@ -42,151 +69,643 @@ void Tuner::processBlock(juce::AudioBuffer<float>& buffer)
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
     
-    // Mix to mono for analysis
-    juce::AudioBuffer<float> monoBuffer(1, numSamples);
-    monoBuffer.clear();
+    if (numChannels == 0 || sampleFifoBuffer.empty())
+        return;
     
-    for (int ch = 0; ch < numChannels; ++ch)
+    // Mix to mono straight into the ring; if the analysis thread has fallen
+    // behind, whatever does not fit is dropped rather than waited for
+    const float channelGain = 1.0f / numChannels;
+
+    auto mixToMono = [&](float* destination, int sourceStart, int count)
+    {
+        juce::FloatVectorOperations::copyWithMultiply(destination, buffer.getReadPointer(0, sourceStart), channelGain, count);
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::addWithMultiply(destination, buffer.getReadPointer(ch, sourceStart), channelGain, count);
+    };
+
+    int start1, size1, start2, size2;
+    sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        mixToMono(sampleFifoBuffer.data() + start1, 0, size1);
+
+    if (size2 > 0)
+        mixToMono(sampleFifoBuffer.data() + start2, size1, size2);
+
+    sampleFifo.finishedWrite(size1 + size2);
+}
+
+const char* Tuner::getNoteName(int noteIndex)
+{
+    return juce::isPositiveAndBelow(noteIndex, 12) ? noteNames[noteIndex] : "--";
+}
+
+//==============================================================================
+void Tuner::run()
+{
+    while (!threadShouldExit())
+    {
+        analysePendingSamples();
+        wait(analysisIdle ? idleIntervalMs : analysisIntervalMs);
+    }
+}
+
+void Tuner::analysePendingSamples()
+{
+    int start1, size1, start2, size2;
+
+    if (resetRequested.exchange(false))
+    {
+        // Discard everything queued before the reset
+        sampleFifo.prepareToRead(sampleFifo.getNumReady(), start1, size1, start2, size2);
+        sampleFifo.finishedRead(size1 + size2);
+        clearAnalysis();
+    }
+
+    // Nobody is looking: drop the samples and skip detection entirely
+    if (!isObserved())
     {
-        monoBuffer.addFrom(0, 0, buffer, ch, 0, numSamples, 1.0f / numChannels);
+        sampleFifo.prepareToRead(sampleFifo.getNumReady(), start1, size1, start2, size2);
+        sampleFifo.finishedRead(size1 + size2);
+
+        if (!analysisIdle)
+        {
+            clearAnalysis();
+            analysisIdle = true;
+        }
+
+        return;
     }
+
+    analysisIdle = false;
     
-    // Copy to analysis buffer
-    const float* monoData = monoBuffer.getReadPointer(0);
     float* analysisData = analysisBuffer.getWritePointer(0);
     
-    for (int i = 0; i < numSamples; ++i)
+    auto consume = [&](const float* samples, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            // Anti-alias, then keep every decimationFactor-th sample
+            const float filtered = antiAliasFilters[1].processSample(antiAliasFilters[0].processSample(samples[i], 0), 0);
+
+            if (++decimationCounter < decimationFactor)
+                continue;
+
+            decimationCounter = 0;
+            analysisData[bufferWritePosition] = filtered;
+            bufferWritePosition = (bufferWritePosition + 1) % analysisBufferSize;
+
+            if (strobeLocked)
+                processStrobeSample(filtered);
+
+            // Perform analysis every hop size
+            if (++samplesSinceLastAnalysis >= analysisHopSize)
+            {
+                samplesSinceLastAnalysis = 0;
+                analyse();
+            }
+        }
+    };
+
+    sampleFifo.prepareToRead(sampleFifo.getNumReady(), start1, size1, start2, size2);
+
+    if (size1 > 0)
+        consume(sampleFifoBuffer.data() + start1, size1);
+
+    if (size2 > 0)
+        consume(sampleFifoBuffer.data() + start2, size2);
+
+    sampleFifo.finishedRead(size1 + size2);
+}
+
+void Tuner::analyse()
+{
+    // Rearrange buffer for analysis (so newest samples are at the end)
+    const float* analysisData = analysisBuffer.getReadPointer(0);
+    float* orderedData = orderedBuffer.getWritePointer(0);
+
+    for (int i = 0; i < analysisBufferSize; ++i)
     {
-        analysisData[bufferWritePosition] = monoData[i];
-        bufferWritePosition = (bufferWritePosition + 1) % analysisBufferSize;
+        int readPos = (bufferWritePosition + i) % analysisBufferSize;
+        orderedData[i] = analysisData[readPos];
     }
     
-    samplesSinceLastAnalysis += numSamples;
+    const auto currentMode = mode.load();
+
+    if (currentMode == Mode::Strobe)
+    {
+        analyseStrobe(orderedData, analysisBufferSize);
+        return;
+    }
+
+    if (strobeLocked)
+        unlockStrobe();
+
+    if (currentMode == Mode::Polyphonic)
+    {
+        analysePolyphonic(orderedData, analysisBufferSize);
+        return;
+    }
+
+    // Detect pitch
+    updateEstimate(detectPitch(orderedData, analysisBufferSize));
+}
     
-    // Perform analysis every hop size
-    if (samplesSinceLastAnalysis >= analysisHopSize)
+void Tuner::updateEstimate(const PitchEstimate& estimate)
+{
+    if (estimate.frequency <= 0.0f || estimate.confidence < minConfidence)
     {
-        samplesSinceLastAnalysis = 0;
-        
-        // Rearrange buffer for analysis (so newest samples are at the end)
-        juce::AudioBuffer<float> orderedBuffer(1, analysisBufferSize);
-        float* orderedData = orderedBuffer.getWritePointer(0);
-        
-        for (int i = 0; i < analysisBufferSize; ++i)
-        {
-            int readPos = (bufferWritePosition + i) % analysisBufferSize;
-            orderedData[i] = analysisData[readPos];
-        }
-        
-        // Detect pitch
-        float frequency = detectPitch(orderedData, analysisBufferSize);
-        
-        if (frequency > 0.0f)
+        // Nothing reliable this hop; start afresh so the next note locks in at once
+        smoothedWeight = 0.0f;
+        candidateCount = 0;
+        reading.store(Reading {});
+        return;
+    }
+
+    // Smooth on a semitone scale so the weighting is the same in every octave
+    const float pitch = 12.0f * std::log2(estimate.frequency / 440.0f);
+
+    if (smoothedWeight <= 0.0f)
+    {
+        smoothedPitch = pitch;
+        smoothedWeight = estimate.confidence;
+    }
+    else if (std::abs(pitch - smoothedPitch) > noteChangeSemitones)
+    {
+        // A new note or an octave error: only follow it once two hops agree
+        if (candidateCount > 0 && std::abs(pitch - candidatePitch) <= noteChangeSemitones)
         {
-            // Add to history for smoothing
-            frequencyHistory[historyWriteIndex] = frequency;
-            historyWriteIndex = (historyWriteIndex + 1) % maxHistorySize;
-            
-            // Calculate average of valid frequencies in history
-            float sum = 0.0f;
-            int count = 0;
-            for (float f : frequencyHistory)
-            {
-                if (f > 0.0f)
-                {
-                    sum += f;
-                    count++;
-                }
-            }
-            
-            if (count > 0)
-            {
-                float smoothedFrequency = sum / count;
-                detectedFrequency = smoothedFrequency;
-                updateNoteInfo(smoothedFrequency);
-                noteDetected = true;
-            }
+            smoothedPitch = pitch;
+            smoothedWeight = estimate.confidence;
+            candidateCount = 0;
         }
         else
         {
-            noteDetected = false;
-            noteName = "--";
-            centsDeviation = 0.0f;
+            candidatePitch = pitch;
+            candidateCount = 1;
         }
     }
+    else
+    {
+        // Confidence-weighted running mean with exponential forgetting
+        candidateCount = 0;
+        smoothedWeight = smoothedWeight * smoothingDecay + estimate.confidence;
+        smoothedPitch += (estimate.confidence / smoothedWeight) * (pitch - smoothedPitch);
+    }
+
+    const float smoothedFrequency = 440.0f * std::exp2(smoothedPitch / 12.0f);
+    reading.store(makeReading(smoothedFrequency, estimate.confidence));
+}
+
+void Tuner::clearAnalysis()
+{
+    analysisBuffer.clear();
+    bufferWritePosition = 0;
+    samplesSinceLastAnalysis = 0;
+    smoothedPitch = 0.0f;
+    smoothedWeight = 0.0f;
+    candidateCount = 0;
+    decimationCounter = 0;
+
+    for (auto& filter : antiAliasFilters)
+        filter.reset();
+
+    smoothedStringCents.fill(0.0f);
+    smoothedStringWeights.fill(0.0f);
+    unlockStrobe();
+
+    reading.store(Reading {});
+    stringReadings.store(StringReadings {});
 }
 
-float Tuner::detectPitch(const float* samples, int numSamples)
+float Tuner::getRMS(const float* samples, int numSamples)
 {
-    // Find RMS to check if signal is strong enough
-    float rms = 0.0f;
+    float sum = 0.0f;
     for (int i = 0; i < numSamples; ++i)
-        rms += samples[i] * samples[i];
-    rms = std::sqrt(rms / numSamples);
-    
-    // Threshold for detection
-    if (rms < 0.01f)
-        return 0.0f;
+        sum += samples[i] * samples[i];
+
+    return std::sqrt(sum / numSamples);
+}
+
+Tuner::PitchEstimate Tuner::detectPitch(const float* samples, int numSamples)
+{
+    // Check the signal is strong enough
+    if (getRMS(samples, numSamples) < 0.01f)
+        return {};
     
-    // Autocorrelation-based pitch detection
-    // Search range: 80 Hz to 1000 Hz (appropriate for guitar)
-    int minLag = static_cast<int>(sampleRate / 1000.0f);
-    int maxLag = static_cast<int>(sampleRate / 80.0f);
+    // Lag window for the guitar range at the decimated rate
+    const int minLag = juce::jmax(2, static_cast<int>(analysisSampleRate / maxFrequency));
+    const int maxLag = juce::jmin(numSamples / 2,
+                                  static_cast<int>(detectionCurve.size()) - 2,
+                                  static_cast<int>(std::ceil(analysisSampleRate / minFrequency)));
     
-    if (maxLag >= numSamples)
-        maxLag = numSamples - 1;
+    // Both detectors are derived from the same autocorrelation pass
+    autocorrelation.process(samples, numSamples);
     
-    float maxCorrelation = 0.0f;
-    int bestLag = 0;
+    return detector.load() == Detector::YIN ? detectPitchYIN(minLag, maxLag)
+                                            : detectPitchMPM(minLag, maxLag);
+}
+
+Tuner::PitchEstimate Tuner::detectPitchYIN(int minLag, int maxLag)
+{
+    const float* correlation = autocorrelation.getCorrelation();
+    const int numSamples = autocorrelation.getNumSamples();
+    float* cmndf = detectionCurve.data();
     
-    for (int lag = minLag; lag < maxLag; ++lag)
+    // Difference function d(lag) = sum((x[i] - x[i + lag])^2) over the overlap,
+    // turned into the cumulative mean normalised difference
+    cmndf[0] = 1.0f;
+    float runningSum = 0.0f;
+
+    for (int lag = 1; lag <= maxLag + 1; ++lag)
     {
-        float corr = autocorrelation(samples, numSamples, lag);
+        const float difference = autocorrelation.getEnergy(0, numSamples - lag)
+                               + autocorrelation.getEnergy(lag, numSamples)
+                               - 2.0f * correlation[lag];
+        runningSum += difference;
+        cmndf[lag] = (runningSum > 0.0f) ? difference * lag / runningSum : 1.0f;
+    }
         
-        if (corr > maxCorrelation)
+    // First dip under the threshold, followed down to its minimum
+    int bestLag = -1;
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        if (cmndf[lag] < yinThreshold)
         {
-            maxCorrelation = corr;
+            while (lag < maxLag && cmndf[lag + 1] < cmndf[lag])
+                ++lag;
+
             bestLag = lag;
+            break;
         }
     }
     
-    // Need strong correlation for reliable detection
-    if (maxCorrelation < 0.5f || bestLag == 0)
-        return 0.0f;
-    
-    // Parabolic interpolation for sub-sample accuracy
-    if (bestLag > minLag && bestLag < maxLag - 1)
+    // Otherwise fall back to the global minimum, which usually scores below minConfidence
+    if (bestLag < 0)
     {
-        float y1 = autocorrelation(samples, numSamples, bestLag - 1);
-        float y2 = maxCorrelation;
-        float y3 = autocorrelation(samples, numSamples, bestLag + 1);
-        
-        float delta = 0.5f * (y3 - y1) / (2.0f * y2 - y1 - y3);
-        float refinedLag = bestLag + delta;
-        
-        return static_cast<float>(sampleRate) / refinedLag;
+        bestLag = minLag;
+        for (int lag = minLag + 1; lag <= maxLag; ++lag)
+        {
+            if (cmndf[lag] < cmndf[bestLag])
+                bestLag = lag;
+        }
     }
     
-    return static_cast<float>(sampleRate) / bestLag;
+    PitchEstimate estimate;
+    estimate.frequency = static_cast<float>(analysisSampleRate / refineLag(cmndf, bestLag, maxLag));
+    estimate.confidence = juce::jlimit(0.0f, 1.0f, 1.0f - cmndf[bestLag]);
+    return estimate;
 }
 
-float Tuner::autocorrelation(const float* data, int numSamples, int lag)
+Tuner::PitchEstimate Tuner::detectPitchMPM(int minLag, int maxLag)
 {
-    float sum = 0.0f;
-    float norm = 0.0f;
-    
-    int count = numSamples - lag;
-    
-    for (int i = 0; i < count; ++i)
+    const float* correlation = autocorrelation.getCorrelation();
+    const int numSamples = autocorrelation.getNumSamples();
+    float* nsdf = detectionCurve.data();
+
+    // Normalised square difference function, in [-1, 1]
+    for (int lag = 0; lag <= maxLag + 1; ++lag)
     {
-        sum += data[i] * data[i + lag];
-        norm += data[i] * data[i];
+        const float norm = autocorrelation.getEnergy(0, numSamples - lag)
+                         + autocorrelation.getEnergy(lag, numSamples);
+        nsdf[lag] = (norm > 0.0f) ? 2.0f * correlation[lag] / norm : 0.0f;
+    }
+
+    // Calls back with the highest point of each positive lobe after the one around lag 0
+    auto forEachKeyMaximum = [&](auto&& callback)
+    {
+        int lag = 1;
+        while (lag <= maxLag && nsdf[lag] > 0.0f)
+            ++lag;
+
+        while (lag <= maxLag)
+        {
+            while (lag <= maxLag && nsdf[lag] <= 0.0f)
+                ++lag;
+
+            int peak = -1;
+            while (lag <= maxLag && nsdf[lag] > 0.0f)
+            {
+                if (peak < 0 || nsdf[lag] > nsdf[peak])
+                    peak = lag;
+                ++lag;
+            }
+
+            if (peak >= minLag)
+                callback(peak);
+        }
+    };
+
+    float highest = 0.0f;
+    forEachKeyMaximum([&](int peak) { highest = juce::jmax(highest, nsdf[peak]); });
+
+    if (highest <= 0.0f)
+        return {};
+
+    // The first peak close to the highest one is the fundamental, which avoids octave errors
+    int bestLag = -1;
+    forEachKeyMaximum([&](int peak)
+    {
+        if (bestLag < 0 && nsdf[peak] >= mpmThreshold * highest)
+            bestLag = peak;
+    });
+
+    PitchEstimate estimate;
+    estimate.frequency = static_cast<float>(analysisSampleRate / refineLag(nsdf, bestLag, maxLag));
+    estimate.confidence = juce::jlimit(0.0f, 1.0f, nsdf[bestLag]);
+    return estimate;
+}
+
+float Tuner::refineLag(const float* curve, int lag, int maxLag) const
+{
+    // Parabolic interpolation for sub-sample accuracy (curve is valid up to maxLag + 1)
+    if (lag <= 0 || lag > maxLag)
+        return static_cast<float>(lag);
+
+    const float y1 = curve[lag - 1];
+    const float y2 = curve[lag];
+    const float y3 = curve[lag + 1];
+    const float denominator = y1 - 2.0f * y2 + y3;
+
+    if (std::abs(denominator) < 1.0e-9f)
+        return static_cast<float>(lag);
+
+    return lag + 0.5f * (y1 - y3) / denominator;
+}
+
+void Tuner::analysePolyphonic(float* samples, int numSamples)
+{
+    // The chromatic result does not apply while strumming
+    reading.store(Reading {});
+
+    StringReadings result;
+
+    if (getRMS(samples, numSamples) < 0.01f)
+    {
+        smoothedStringWeights.fill(0.0f);
+        stringReadings.store(result);
+        return;
+    }
+
+    // One windowed spectrum per hop, on the autocorrelation's FFT plan and buffers
+    // (samples is the ordered scratch frame, so it can be windowed in place)
+    juce::FloatVectorOperations::multiply(samples, spectrumWindow.data(), numSamples);
+    autocorrelation.processSpectrum(samples, numSamples);
+
+    // The loudest partial in the guitar range is the reference for what counts as played
+    const float binsPerHz = static_cast<float>(autocorrelation.getFFTSize() / analysisSampleRate);
+    const int firstBin = static_cast<int>(minFrequency * binsPerHz);
+    const int lastBin = juce::jmin(autocorrelation.getFFTSize() / 2,
+                                   static_cast<int>(maxFrequency * binsPerHz));
+    float peakPower = 0.0f;
+
+    for (int bin = firstBin; bin <= lastBin; ++bin)
+        peakPower = juce::jmax(peakPower, autocorrelation.getPower(bin));
+
+    if (peakPower <= 0.0f)
+    {
+        stringReadings.store(result);
+        return;
+    }
+
+    const int numSteps = static_cast<int>(2.0f * stringSearchCents / stringSearchStepCents);
+
+    for (int stringIndex = 0; stringIndex < numStrings; ++stringIndex)
+    {
+        const float target = standardTuning[stringIndex];
+
+        auto frequencyAt = [target](float cents) { return target * std::exp2(cents / 1200.0f); };
+        auto scoreAtStep = [&](int step) { return getHarmonicScore(frequencyAt(-stringSearchCents + step * stringSearchStepCents)); };
+
+        // Harmonic product (as a sum of logs) over a fine grid around the string's pitch
+        int bestStep = 0;
+        float bestScore = scoreAtStep(0);
+
+        for (int step = 1; step <= numSteps; ++step)
+        {
+            const float score = scoreAtStep(step);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestStep = step;
+            }
+        }
+
+        float cents = -stringSearchCents + bestStep * stringSearchStepCents;
+
+        // Parabolic interpolation between grid points
+        if (bestStep > 0 && bestStep < numSteps)
+        {
+            const float y1 = scoreAtStep(bestStep - 1);
+            const float y3 = scoreAtStep(bestStep + 1);
+            const float denominator = y1 - 2.0f * bestScore + y3;
+
+            if (std::abs(denominator) > 1.0e-9f)
+                cents += 0.5f * stringSearchStepCents * (y1 - y3) / denominator;
+        }
+
+        // A string is played when its fundamental or octave stands out in the spectrum
+        const float frequency = frequencyAt(cents);
+        const float logLevel = juce::jmax(getLogPowerAt(frequency), getLogPowerAt(2.0f * frequency));
+        const float levelDb = 10.0f * (logLevel - std::log(peakPower)) / std::log(10.0f);
+
+        auto& stringReading = result[static_cast<size_t>(stringIndex)];
+        auto& stringCents = smoothedStringCents[static_cast<size_t>(stringIndex)];
+        auto& stringWeight = smoothedStringWeights[static_cast<size_t>(stringIndex)];
+
+        if (levelDb < stringPresenceDb)
+        {
+            stringWeight = 0.0f;
+            continue;
+        }
+
+        // Same confidence-weighted smoothing as the chromatic tuner, per string
+        const float confidence = juce::jlimit(0.0f, 1.0f, 1.0f - levelDb / stringPresenceDb);
+        const float weight = juce::jmax(confidence, 0.01f);
+
+        if (stringWeight <= 0.0f)
+        {
+            stringCents = cents;
+            stringWeight = weight;
+        }
+        else
+        {
+            stringWeight = stringWeight * smoothingDecay + weight;
+            stringCents += (weight / stringWeight) * (cents - stringCents);
+        }
+
+        stringReading.frequency = frequencyAt(stringCents);
+        stringReading.cents = stringCents;
+        stringReading.confidence = confidence;
+        stringReading.detected = true;
+    }
+
+    stringReadings.store(result);
+}
+
+float Tuner::getLogPowerAt(float frequency) const
+{
+    // Parabolic interpolation of log power around the nearest bin, which follows
+    // the shape of a windowed peak far better than interpolating power linearly
+    const float position = frequency * static_cast<float>(autocorrelation.getFFTSize() / analysisSampleRate);
+    const int bin = juce::roundToInt(position);
+
+    if (bin < 1 || bin + 1 > autocorrelation.getFFTSize() / 2)
+        return std::log(1.0e-12f);
+
+    const float y1 = std::log(autocorrelation.getPower(bin - 1) + 1.0e-12f);
+    const float y2 = std::log(autocorrelation.getPower(bin) + 1.0e-12f);
+    const float y3 = std::log(autocorrelation.getPower(bin + 1) + 1.0e-12f);
+    const float offset = position - bin;
+
+    return y2 + 0.5f * offset * (y3 - y1) + 0.5f * offset * offset * (y1 - 2.0f * y2 + y3);
+}
+
+float Tuner::getHarmonicScore(float frequency) const
+{
+    float score = 0.0f;
+    for (int harmonic = 1; harmonic <= numHarmonics; ++harmonic)
+        score += getLogPowerAt(harmonic * frequency);
+
+    return score;
+}
+
+void Tuner::analyseStrobe(const float* samples, int numSamples)
+{
+    // Coarse detection only chooses the note to lock to, so it runs every few hops
+    if (!strobeLocked || ++strobeHopCounter >= strobeCoarseHops)
+    {
+        strobeHopCounter = 0;
+        updateEstimate(detectPitch(samples, numSamples));
+
+        const auto coarse = reading.load();
+
+        if (!coarse.isNoteDetected())
+        {
+            unlockStrobe();
+            return;
+        }
+
+        const int semitone = juce::roundToInt(12.0f * std::log2(coarse.frequency / 440.0f));
+
+        if (!strobeLocked || semitone != strobeSemitone)
+            lockStrobe(semitone);
+    }
+
+    // Keep the oscillators on the unit circle despite rounding
+    for (auto& band : strobeBands)
+        band.oscillator /= std::abs(band.oscillator);
+
+    StrobeReading result;
+    const auto note = makeReading(strobeTargetFrequency, 1.0f);
+    result.noteIndex = note.noteIndex;
+    result.octave = note.octave;
+    result.targetFrequency = strobeTargetFrequency;
+
+    // Phase advance of each band over the last hop gives its frequency offset
+    const float hopSeconds = static_cast<float>(analysisHopSize / analysisSampleRate);
+    const float twoPi = juce::MathConstants<float>::twoPi;
+    float fundamentalAdvance = 0.0f;
+    float weightedOffset = 0.0f;
+    float totalWeight = 0.0f;
+    float strongest = 0.0f;
+
+    auto wrapPhase = [twoPi](float phase) { return phase - twoPi * std::round(phase / twoPi); };
+
+    for (int h = 0; h < numStrobeBands; ++h)
+    {
+        auto& band = strobeBands[static_cast<size_t>(h)];
+        if (!band.active)
+            continue;
+
+        const float level = std::abs(band.lowpass2);
+        const float phase = std::arg(band.lowpass2);
+
+        // Harmonic bands drift h + 1 times faster, so unwrap them against the fundamental
+        const float rawAdvance = wrapPhase(phase - band.lastPhase);
+        const float advance = (h == 0) ? rawAdvance
+                                       : fundamentalAdvance * (h + 1) + wrapPhase(rawAdvance - fundamentalAdvance * (h + 1));
+        band.lastPhase = phase;
+
+        if (h == 0)
+            fundamentalAdvance = rawAdvance;
+
+        weightedOffset += level * advance / (twoPi * hopSeconds * (h + 1));
+        totalWeight += level;
+        strongest = juce::jmax(strongest, level);
+
+        result.phases[static_cast<size_t>(h)] = phase;
+        result.levels[static_cast<size_t>(h)] = level;
+    }
+
+    if (strongest > 0.0f)
+    {
+        for (auto& level : result.levels)
+            level /= strongest;
+    }
+
+    // Band filters need a few hops after locking before their phase means anything
+    if (strobeSettleCounter > 0)
+    {
+        --strobeSettleCounter;
+    }
+    else if (totalWeight > 0.0f)
+    {
+        const float offsetHz = weightedOffset / totalWeight;
+        const float cents = 1200.0f * std::log2((strobeTargetFrequency + offsetHz) / strobeTargetFrequency);
+        strobeCents = smoothingDecay * strobeCents + (1.0f - smoothingDecay) * cents;
+    }
+
+    result.cents = strobeCents;
+    strobeReading.store(result);
+}
+
+void Tuner::lockStrobe(int semitonesFromA4)
+{
+    strobeLocked = true;
+    strobeSemitone = semitonesFromA4;
+    strobeTargetFrequency = 440.0f * std::exp2(semitonesFromA4 / 12.0f);
+    strobeHopCounter = 0;
+    strobeSettleCounter = strobeSettleHops;
+    strobeCents = 0.0f;
+
+    for (int h = 0; h < numStrobeBands; ++h)
+    {
+        auto& band = strobeBands[static_cast<size_t>(h)];
+        const float bandFrequency = strobeTargetFrequency * (h + 1);
+        const float omega = juce::MathConstants<float>::twoPi * bandFrequency / static_cast<float>(analysisSampleRate);
+
+        // Harmonics too close to the decimated Nyquist are left out
+        band = StrobeBand {};
+        band.active = bandFrequency < 0.45f * static_cast<float>(analysisSampleRate);
+        band.rotation = std::polar(1.0f, -omega);
+    }
+}
+
+void Tuner::unlockStrobe()
+{
+    strobeLocked = false;
+    strobeCents = 0.0f;
+    strobeReading.store(StrobeReading {});
+}
+
+void Tuner::processStrobeSample(float sample)
+{
+    // Mix each harmonic down to 0 Hz and low pass it; what remains turns at the detuning
+    for (auto& band : strobeBands)
+    {
+        if (!band.active)
+            continue;
+
+        const auto mixed = sample * band.oscillator;
+        band.lowpass1 += strobeLowpassCoefficient * (mixed - band.lowpass1);
+        band.lowpass2 += strobeLowpassCoefficient * (band.lowpass1 - band.lowpass2);
+        band.oscillator *= band.rotation;
     }
-    
-    return (norm > 0.0f) ? sum / norm : 0.0f;
 }
 
-void Tuner::updateNoteInfo(float frequency)
+Tuner::Reading Tuner::makeReading(float frequency, float confidence)
 {
     // A4 = 440 Hz reference
     const float A4 = 440.0f;
@@ -197,21 +716,29 @@ void Tuner::updateNoteInfo(float frequency)
     // Round to nearest semitone to get note
     int semitoneIndex = static_cast<int>(std::round(semitonesFromA4));
     
+    Reading result;
+    result.frequency = frequency;
+    result.confidence = confidence;
+
     // Calculate cents deviation from that note
-    centsDeviation = 100.0f * (semitonesFromA4 - semitoneIndex);
+    result.cents = 100.0f * (semitonesFromA4 - semitoneIndex);
     
-    // Get note name and octave
-    int noteIndex = (semitoneIndex + 9) % 12; // +9 because A is index 9
-    if (noteIndex < 0) noteIndex += 12;
+    // Get note index and octave (+9 because A is index 9), rounding the octave
+    // down so notes below C4 are not placed an octave too high
+    const int semitonesFromC4 = semitoneIndex + 9;
+    const int octaveOffset = (semitonesFromC4 >= 0) ? semitonesFromC4 / 12 : -((11 - semitonesFromC4) / 12);
     
-    int octave = 4 + (semitoneIndex + 9) / 12;
-    
-    noteName = juce::String(noteNames[noteIndex]) + juce::String(octave);
+    result.noteIndex = semitonesFromC4 - 12 * octaveOffset;
+    result.octave = 4 + octaveOffset;
+    return result;
 }
 
 std::unique_ptr<juce::XmlElement> Tuner::getStateInformation() const
 {
     auto xml = std::make_unique<juce::XmlElement>("Tuner");
+    xml->setAttribute("detector", getDetector() == Detector::YIN ? "yin" : "mpm");
+    xml->setAttribute("mode", getMode() == Mode::Polyphonic ? "polyphonic"
+                              : getMode() == Mode::Strobe ? "strobe" : "chromatic");
     xml->setAttribute("bypassed", bypassed);
     return xml;
 }
@@ -220,19 +747,41 @@ void Tuner::setStateInformation(const juce::XmlElement& xml)
 {
     if (xml.hasTagName("Tuner"))
     {
+        setDetector(xml.getStringAttribute("detector", "mpm") == "yin" ? Detector::YIN : Detector::MPM);
+        const auto modeName = xml.getStringAttribute("mode", "chromatic");
+        setMode(modeName == "polyphonic" ? Mode::Polyphonic : modeName == "strobe" ? Mode::Strobe : Mode::Chromatic);
         bypassed = xml.getBoolAttribute("bypassed", false);
     }
 }
 
-void Tuner::addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                                   const juce::String& prefix)
+const std::vector<EffectBase::ParameterInfo>& Tuner::getParameterInfo() const
+{
+    // Order must match ParameterIndex
+    static const std::vector<ParameterInfo> parameters
+    {
+        { "detector", "Detector (YIN/MPM)", juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 1.0f },
+        { "mode",     "Mode (Chromatic/Poly/Strobe)", juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f }
+    };
+
+    return parameters;
+}
+
+void Tuner::setParameter(int index, float value)
 {
-    // Tuner has no adjustable parameters, just display values
-    // We could add reference frequency adjustment in the future
+    switch (index)
+    {
+        case detectorIndex: setDetector(value < 0.5f ? Detector::YIN : Detector::MPM); break;
+        case modeIndex: setMode(value < 0.5f ? Mode::Chromatic : (value < 1.5f ? Mode::Polyphonic : Mode::Strobe)); break;
+        default: break;
+    }
 }
 
-void Tuner::linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                           const juce::String& prefix)
+float Tuner::getParameter(int index) const
 {
-    // No parameters to link
+    switch (index)
+    {
+        case detectorIndex: return getDetector() == Detector::YIN ? 0.0f : 1.0f;
+        case modeIndex: return static_cast<float>(static_cast<int>(getMode()));
+        default: return 0.0f;
+    }
 }
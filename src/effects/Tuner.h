@@ -1,10 +1,49 @@
 #pragma once
 
 #include "EffectBase.h"
+#include "../dsp/Autocorrelation.h"
+#include "../dsp/Filter.h"
+#include "../dsp/SeqLock.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <complex>
 
-class Tuner : public EffectBase
+/**
+ * Chromatic tuner. Passes audio through unchanged.
+ *
+ * The audio thread only mixes each block to mono and pushes it into a
+ * lock-free single-producer/single-consumer ring. A background analysis
+ * thread drains the ring, runs pitch detection every analysisHopSize
+ * samples and publishes the result, so the cost on the audio thread does
+ * not depend on the detection algorithm.
+ *
+ * Guitar fundamentals sit below 1.4 kHz, so the analysis thread low-passes
+ * and decimates the signal 4x to 8x (to roughly 5.5 kHz) before detection.
+ * Detection uses YIN or the McLeod pitch method (MPM), both built on one
+ * FFT autocorrelation, and each estimate carries a confidence that weights
+ * the smoothing.
+ *
+ * Results are published as a plain Reading through a sequence lock, so the
+ * UI can poll getReading() from any thread without locks or heap traffic
+ * and formats any text itself.
+ *
+ * In polyphonic mode all six strings are strummed at once: the analysis
+ * thread takes one windowed power spectrum per hop (on the same FFT plan
+ * and buffers) and scores each string by the harmonic product around its
+ * standard-tuning pitch.
+ *
+ * In strobe mode the coarse detector only picks the note to lock to (every
+ * few hops). A small bank of complex heterodyne detectors, one per harmonic
+ * of that note, then follows the phase drift sample by sample. That is O(N)
+ * per hop with no FFT, and resolves a fraction of a cent.
+ *
+ * Detection only runs while the tuner is observed (see EffectBase::addObserver).
+ * Otherwise the analysis thread just drains the ring at a slower rate.
+ */
+class Tuner : public EffectBase,
+              private juce::Thread
 {
 public:
     Tuner();
@@ -23,43 +62,202 @@ public:
     std::unique_ptr<juce::XmlElement> getStateInformation() const override;
     void setStateInformation(const juce::XmlElement& xml) override;
 
-    // Parameter layout for APVTS
-    void addParametersToLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
-                               const juce::String& prefix) override;
-    void linkParameters(juce::AudioProcessorValueTreeState& apvts,
-                       const juce::String& prefix) override;
+    // Parameters
+    enum ParameterIndex { detectorIndex = 0, modeIndex };
+    const std::vector<ParameterInfo>& getParameterInfo() const override;
+    void setParameter(int index, float value) override;
+    float getParameter(int index) const override;
 
-    // Tuner-specific getters
-    float getDetectedFrequency() const { return detectedFrequency; }
-    juce::String getNoteName() const { return noteName; }
-    float getCentsDeviation() const { return centsDeviation; }
-    bool isNoteDetected() const { return noteDetected; }
-    int getTuningDirection() const { return centsDeviation > 5.0f ? 1 : (centsDeviation < -5.0f ? -1 : 0); }
+    enum class Detector
+    {
+        YIN,
+        MPM
+    };
+
+    void setDetector(Detector newDetector) { detector = newDetector; }
+    Detector getDetector() const { return detector.load(); }
+
+    enum class Mode
+    {
+        Chromatic,      // One note, any pitch
+        Polyphonic,     // All six strings at once, standard tuning
+        Strobe          // One note, phase-tracked for fine tuning
+    };
+
+    void setMode(Mode newMode) { mode = newMode; }
+    Mode getMode() const { return mode.load(); }
+
+    /** Result of one analysis. Trivially copyable so it can be published lock-free. */
+    struct Reading
+    {
+        float frequency = 0.0f;     // Smoothed fundamental in Hz
+        int noteIndex = -1;         // 0 = C ... 11 = B, or -1 when no note is detected
+        int octave = 0;             // Scientific pitch notation (A4 = 440 Hz)
+        float cents = 0.0f;         // Deviation from the nearest note
+        float confidence = 0.0f;    // 0 to 1, from the detector
+
+        bool isNoteDetected() const { return noteIndex >= 0; }
+        int getTuningDirection() const { return cents > 5.0f ? 1 : (cents < -5.0f ? -1 : 0); }
+    };
+
+    /** Returns the most recent result. Safe to call from any thread. */
+    Reading getReading() const { return reading.load(); }
+
+    /** Polyphonic result for one string. */
+    struct StringReading
+    {
+        float frequency = 0.0f;     // Detected fundamental in Hz
+        float cents = 0.0f;         // Deviation from the string's standard-tuning pitch
+        float confidence = 0.0f;    // 0 to 1, from the string's level relative to the loudest partial
+        bool detected = false;
+
+        int getTuningDirection() const { return cents > 5.0f ? 1 : (cents < -5.0f ? -1 : 0); }
+    };
+
+    static constexpr int numStrings = 6;
+    using StringReadings = std::array<StringReading, numStrings>;
+
+    /** Returns the most recent polyphonic result, low E first. Safe to call from any thread. */
+    StringReadings getStringReadings() const { return stringReadings.load(); }
+
+    /** Returns the standard-tuning pitch of a string (0 = low E) in Hz. */
+    static float getStringFrequency(int stringIndex) { return standardTuning[stringIndex]; }
+
+    /** Strobe result. Band h (from 0) follows harmonic h + 1 of the locked note. */
+    static constexpr int numStrobeBands = 3;
+
+    struct StrobeReading
+    {
+        int noteIndex = -1;                             // Locked note, or -1 when not locked
+        int octave = 0;
+        float targetFrequency = 0.0f;                   // Equal-tempered pitch of the locked note
+        float cents = 0.0f;                             // Fine deviation from targetFrequency
+        std::array<float, numStrobeBands> phases {};    // Radians; band h drifts h + 1 times as fast
+        std::array<float, numStrobeBands> levels {};    // 0 to 1, relative to the strongest band
+
+        bool isLocked() const { return noteIndex >= 0; }
+    };
+
+    /** Returns the most recent strobe result. Safe to call from any thread. */
+    StrobeReading getStrobeReading() const { return strobeReading.load(); }
+
+    /** Returns the name of a note index ("C" to "B"). */
+    static const char* getNoteName(int noteIndex);
 
 private:
-    // Pitch detection
-    float detectPitch(const float* samples, int numSamples);
-    float autocorrelation(const float* data, int numSamples, int lag);
-    void updateNoteInfo(float frequency);
+    // Analysis thread
+    void run() override;
+    void analysePendingSamples();
+    void analyse();
+    void clearAnalysis();
+
+    // Pitch detection (frequencies in Hz at the full sample rate)
+    struct PitchEstimate
+    {
+        float frequency = 0.0f;
+        float confidence = 0.0f;
+    };
+
+    static float getRMS(const float* samples, int numSamples);
+    PitchEstimate detectPitch(const float* samples, int numSamples);
+    PitchEstimate detectPitchYIN(int minLag, int maxLag);
+    PitchEstimate detectPitchMPM(int minLag, int maxLag);
+    float refineLag(const float* curve, int lag, int maxLag) const;
+    void updateEstimate(const PitchEstimate& estimate);
+    static Reading makeReading(float frequency, float confidence);
+
+    // Polyphonic detection
+    void analysePolyphonic(float* samples, int numSamples);
+    float getLogPowerAt(float frequency) const;
+    float getHarmonicScore(float frequency) const;
+
+    // Strobe detection
+    void analyseStrobe(const float* samples, int numSamples);
+    void lockStrobe(int semitonesFromA4);
+    void unlockStrobe();
+    void processStrobeSample(float sample);
+
+    std::atomic<Detector> detector { Detector::MPM };
+    std::atomic<Mode> mode { Mode::Chromatic };
     
-    // Tuner state
-    float detectedFrequency = 0.0f;
-    juce::String noteName = "--";
-    float centsDeviation = 0.0f;
-    bool noteDetected = false;
+    // Latest results, written by the analysis thread only
+    SeqLock<Reading> reading;
+    SeqLock<StringReadings> stringReadings;
+    SeqLock<StrobeReading> strobeReading;
     
-    // Processing buffers
+    // Audio thread -> analysis thread sample ring
+    static constexpr int sampleFifoSize = 16384;
+    juce::AbstractFifo sampleFifo { sampleFifoSize };
+    std::vector<float> sampleFifoBuffer;
+    std::atomic<bool> resetRequested { false };
+    static constexpr int analysisIntervalMs = 5;
+    static constexpr int idleIntervalMs = 50;          // While unobserved; well inside the ring's length
+    bool analysisIdle = false;
+
+    // Anti-aliasing and decimation (analysis thread only)
+    SimpleFilter antiAliasFilters[2];   // 4th order Butterworth as two biquads
+    int decimationFactor = 8;
+    int decimationCounter = 0;
+    double analysisSampleRate = 44100.0 / 8.0;
+    static constexpr double targetAnalysisSampleRate = 5500.0;
+
+    // Processing buffers (analysis thread only, decimated rate)
     juce::AudioBuffer<float> analysisBuffer;
+    juce::AudioBuffer<float> orderedBuffer;
     int bufferWritePosition = 0;
-    static constexpr int analysisBufferSize = 8192;
-    static constexpr int analysisHopSize = 512;
+    static constexpr int analysisBufferSize = 1024;   // ~190 ms
+    static constexpr int analysisHopSize = 64;        // ~12 ms
     int samplesSinceLastAnalysis = 0;
+    FFTAutocorrelation autocorrelation;
+    std::vector<float> detectionCurve;                // YIN CMNDF or MPM NSDF, one value per lag
     
-    // Smoothing for stability (0.5 second averaging)
-    std::vector<float> frequencyHistory;
-    static constexpr int maxHistorySize = 25; // ~0.5 seconds at 50Hz update rate
-    int historyWriteIndex = 0;
+    // Search range
+    static constexpr float minFrequency = 60.0f;
+    static constexpr float maxFrequency = 1400.0f;
+    static constexpr float yinThreshold = 0.15f;       // CMNDF dip that counts as periodic
+    static constexpr float mpmThreshold = 0.9f;        // Fraction of the highest NSDF peak to accept
+
+    // Confidence-weighted smoothing, done on a semitone scale
+    static constexpr float minConfidence = 0.5f;
+    static constexpr float smoothingDecay = 0.85f;     // Per hop, ~80 ms time constant
+    static constexpr float noteChangeSemitones = 0.5f;
+    float smoothedPitch = 0.0f;                        // Semitones from A4
+    float smoothedWeight = 0.0f;                       // 0 when there is no estimate
+    float candidatePitch = 0.0f;                       // A jump waiting for confirmation
+    int candidateCount = 0;
     
+    // Polyphonic mode
+    static constexpr float standardTuning[numStrings] = { 82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f };
+    static constexpr int numHarmonics = 2;                // Higher partials collide across open strings (A2 x 3 = E4)
+    static constexpr float stringSearchCents = 100.0f;    // Search window either side of each string
+    static constexpr float stringSearchStepCents = 2.0f;
+    static constexpr float stringPresenceDb = -30.0f;     // Relative to the loudest partial
+    std::vector<float> spectrumWindow;                    // Hann window for the spectrum frame
+    std::array<float, numStrings> smoothedStringCents {};
+    std::array<float, numStrings> smoothedStringWeights {};
+
+    // Strobe mode
+    struct StrobeBand
+    {
+        std::complex<float> oscillator { 1.0f, 0.0f };
+        std::complex<float> rotation { 1.0f, 0.0f };   // One sample's step of the band's frequency
+        std::complex<float> lowpass1, lowpass2;         // Two one-pole stages isolate the band
+        float lastPhase = 0.0f;
+        bool active = false;
+    };
+
+    std::array<StrobeBand, numStrobeBands> strobeBands;
+    static constexpr int strobeCoarseHops = 8;           // Coarse detection every ~90 ms
+    static constexpr int strobeSettleHops = 3;           // Let the band filters settle after locking
+    static constexpr float strobeBandwidthHz = 8.0f;
+    bool strobeLocked = false;
+    int strobeSemitone = 0;                              // Locked note, in semitones from A4
+    float strobeTargetFrequency = 0.0f;
+    float strobeLowpassCoefficient = 0.0f;
+    float strobeCents = 0.0f;
+    int strobeHopCounter = 0;
+    int strobeSettleCounter = 0;
+
     // Note names
     static constexpr const char* noteNames[12] = {
         "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
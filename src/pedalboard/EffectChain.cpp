@@ -1,25 +1,63 @@
 #include "EffectChain.h"
 #include "EffectFactory.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 EffectChain::EffectChain()
 {
+    // The audio thread always has a snapshot to iterate, even before the first edit
+    activeSnapshot = new ChainSnapshot();
 }
 
 EffectChain::~EffectChain()
 {
+    stopTimer();
+
+    delete pendingSnapshot.exchange(nullptr);
+    collectRetiredSnapshots();
+    delete activeSnapshot;
 }
 
-void EffectChain::prepare(double newSampleRate, int newSamplesPerBlock)
+void EffectChain::prepare(double newSampleRate, int newSamplesPerBlock, int newNumChannels)
 {
     sampleRate = newSampleRate;
     samplesPerBlock = newSamplesPerBlock;
+    numChannels = newNumChannels;
+    preparedOversamplingStages = oversamplingStages;
+
+    // Oversamplers for the old settings stay alive only as long as snapshots use them
+    runOversamplers.clear();
     
     // Prepare all effects in the chain
-    for (auto& effect : effects)
+    for (size_t i = 0; i < effects.size(); ++i)
     {
-        if (effect)
-            effect->prepare(sampleRate, samplesPerBlock);
+        if (effects[i])
+            prepareEffect(*effects[i]);
+
+        bypassDelays[i] = createBypassDelay();
     }
+
+    // Nothing is processing while the chain prepares, so the regrouped chain can go live at once
+    delete pendingSnapshot.exchange(nullptr);
+    delete activeSnapshot;
+    activeSnapshot = createSnapshot().release();
+}
+
+void EffectChain::setOversampling(int numStages) noexcept
+{
+    oversamplingStages = juce::jlimit(0, maxOversamplingStages, numStages);
+}
+
+void EffectChain::setOversamplingFilter(Oversampler::FilterType newFilterType)
+{
+    if (newFilterType == oversamplingFilter)
+        return;
+
+    // Fresh oversamplers for the new design; the live snapshot keeps its own until it is retired
+    oversamplingFilter = newFilterType;
+    runOversamplers.clear();
+    publishSnapshot();
 }
 
 void EffectChain::reset()
@@ -30,28 +68,182 @@ void EffectChain::reset()
         if (effect)
             effect->reset();
     }
+
+    for (auto& delay : bypassDelays)
+        delay->reset();
 }
 
 void EffectChain::processBlock(juce::AudioBuffer<float>& buffer)
 {
-    // Process through each effect in sequence
-    for (auto& effect : effects)
+    updateActiveSnapshot();
+
+    const int numSamples = buffer.getNumSamples();
+
+    // Without automation the whole block goes through in one pass
+    if (!updateParameters())
+    {
+        processEffects(buffer, 0, numSamples);
+        return;
+    }
+
+    // Step automated parameters towards their new values, one control quantum at a time
+    for (int start = 0; start < numSamples; start += automationQuantum)
+    {
+        const int length = juce::jmin(automationQuantum, numSamples - start);
+        applyParameterRamps(static_cast<float>(start + length) / static_cast<float>(numSamples));
+        processEffects(buffer, start, length);
+    }
+}
+
+void EffectChain::processEffects(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const auto& snapshot = *activeSnapshot;
+
+    // Process through each run, and each effect in it, in sequence
+    for (const auto& run : snapshot.runs)
+    {
+        if (run.oversampling != nullptr)
+        {
+            // The oversampler only holds the prepared block size, which hosts may exceed
+            for (int start = 0; start < numSamples; start += samplesPerBlock)
+                processOversampledRun(run, buffer, startSample + start, juce::jmin(samplesPerBlock, numSamples - start));
+
+            continue;
+        }
+
+        for (int i = run.firstEffect; i < run.firstEffect + run.numEffects; ++i)
+        {
+            processEffect(*snapshot.effects[static_cast<size_t>(i)], *snapshot.bypassDelays[static_cast<size_t>(i)],
+                          buffer, startSample, numSamples);
+        }
+    }
+}
+
+void EffectChain::processEffect(EffectBase& effect, DelayCompensator& bypassDelay, juce::AudioBuffer<float>& buffer,
+                                int startSample, int numSamples)
+{
+    const int latency = effect.getLatencySamples();
+
+    if (latency > 0)
     {
-        if (effect && !effect->isBypassed())
+        // The bypass delay is allocated for maxBypassDelay; anything longer would be clamped and misalign
+        jassert(latency <= maxBypassDelay);
+        bypassDelay.setDelay(latency);
+        auto block = juce::dsp::AudioBlock<float>(buffer).getSubBlock(static_cast<size_t>(startSample),
+                                                                      static_cast<size_t>(numSamples));
+
+        if (effect.isBypassed())
         {
-            effect->processBlock(buffer);
+            bypassDelay.process(block);
+            return;
         }
+
+        // Keep the history current so a switch to bypass lines up straight away
+        bypassDelay.write(block);
+    }
+
+    if (!effect.isBypassed())
+    {
+        effect.processRange(buffer, startSample, numSamples);
+    }
+}
+
+void EffectChain::processOversampledRun(const ChainSnapshot::Run& run, juce::AudioBuffer<float>& buffer,
+                                        int startSample, int numSamples)
+{
+    // Converts even when every pedal in the run is bypassed, so the chain's latency stays put
+    auto block = juce::dsp::AudioBlock<float>(buffer).getSubBlock(static_cast<size_t>(startSample),
+                                                                  static_cast<size_t>(numSamples));
+    auto oversampledBlock = run.oversampling->processSamplesUp(block);
+
+    // The effects take buffers; wrap the oversampler's channels without copying or allocating
+    std::array<float*, maxRunChannels> channels {};
+    const auto numRunChannels = juce::jmin(oversampledBlock.getNumChannels(), channels.size());
+
+    for (size_t channel = 0; channel < numRunChannels; ++channel)
+        channels[channel] = oversampledBlock.getChannelPointer(channel);
+
+    juce::AudioBuffer<float> oversampledBuffer(channels.data(), static_cast<int>(numRunChannels),
+                                               static_cast<int>(oversampledBlock.getNumSamples()));
+
+    for (int i = run.firstEffect; i < run.firstEffect + run.numEffects; ++i)
+    {
+        processEffect(*activeSnapshot->effects[static_cast<size_t>(i)], *activeSnapshot->bypassDelays[static_cast<size_t>(i)],
+                      oversampledBuffer, 0, oversampledBuffer.getNumSamples());
     }
+
+    run.oversampling->processSamplesDown(block);
+}
+
+void EffectChain::setParameterSource(ParameterSource newSource)
+{
+    parameterSource = std::move(newSource);
+    publishSnapshot();
+}
+
+void EffectChain::rebindParameters()
+{
+    publishSnapshot();
 }
 
-void EffectChain::addEffect(std::unique_ptr<EffectBase> effect)
+int EffectChain::getLatencySamples() const
 {
-    if (effect)
+    const int factor = 1 << preparedOversamplingStages;
+    int latency = 0;
+    int oversampledLatency = 0;   // Of effects inside oversampled runs, at the oversampled rate
+    bool inOversampledRun = false;
+
+    for (const auto& effect : effects)
     {
-        // Prepare the new effect with current settings
-        effect->prepare(sampleRate, samplesPerBlock);
-        effects.push_back(std::move(effect));
+        const bool oversampled = effect->isHostOversampled();
+
+        // Every oversampled run converts once, with the same oversampler design
+        if (oversampled && !inOversampledRun && !runOversamplers.empty())
+            latency += runOversamplers.front()->getLatencyInSamples();
+
+        if (oversampled)
+            oversampledLatency += effect->getLatencySamples();
+        else
+            latency += effect->getLatencySamples();
+
+        inOversampledRun = oversampled;
     }
+
+    return latency + (oversampledLatency + factor - 1) / factor;
+}
+
+int EffectChain::getTailSamples() const
+{
+    const int factor = 1 << preparedOversamplingStages;
+    juce::int64 tail = 0;
+
+    // In series, each effect's tail runs on through the ones after it
+    for (const auto& effect : effects)
+        tail += effect->getTailSamples() / (effect->isHostOversampled() ? factor : 1);
+
+    return static_cast<int>(juce::jmin<juce::int64>(tail, std::numeric_limits<int>::max()));
+}
+
+bool EffectChain::addEffect(std::unique_ptr<EffectBase> effect)
+{
+    if (!effect)
+        return false;
+
+    const int slot = findFreeSlot();
+    if (slot < 0)
+        return false;
+
+    // Prepare the new effect with current settings before the audio thread can see it
+    prepareEffect(*effect);
+
+    if (onSlotChanged)
+        onSlotChanged(slot, effect.get());
+
+    effects.push_back(std::move(effect));
+    effectSlots.push_back(slot);
+    bypassDelays.push_back(createBypassDelay());
+    publishSnapshot();
+    return true;
 }
 
 bool EffectChain::removeEffect(int index)
@@ -59,7 +251,15 @@ bool EffectChain::removeEffect(int index)
     if (index < 0 || index >= static_cast<int>(effects.size()))
         return false;
     
+    const int slot = effectSlots[static_cast<size_t>(index)];
     effects.erase(effects.begin() + index);
+    effectSlots.erase(effectSlots.begin() + index);
+    bypassDelays.erase(bypassDelays.begin() + index);
+
+    if (onSlotChanged)
+        onSlotChanged(slot, nullptr);
+
+    publishSnapshot();
     return true;
 }
 
@@ -72,21 +272,37 @@ bool EffectChain::moveEffect(int fromIndex, int toIndex)
         return false;
     }
     
-    // Move the effect to the new position
+    // Move the effect (and its slot) to the new position
     auto effect = std::move(effects[fromIndex]);
+    const int slot = effectSlots[static_cast<size_t>(fromIndex)];
+    auto bypassDelay = std::move(bypassDelays[static_cast<size_t>(fromIndex)]);
     effects.erase(effects.begin() + fromIndex);
+    effectSlots.erase(effectSlots.begin() + fromIndex);
+    bypassDelays.erase(bypassDelays.begin() + fromIndex);
     
     // Adjust toIndex if necessary (if we removed an element before the target)
     if (fromIndex < toIndex)
         toIndex--;
     
     effects.insert(effects.begin() + toIndex, std::move(effect));
+    effectSlots.insert(effectSlots.begin() + toIndex, slot);
+    bypassDelays.insert(bypassDelays.begin() + toIndex, std::move(bypassDelay));
+    publishSnapshot();
     return true;
 }
 
 void EffectChain::clearChain()
 {
-    effects.clear();
+    releaseAllSlots();
+    publishSnapshot();
+}
+
+int EffectChain::getEffectSlot(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(effectSlots.size()))
+        return -1;
+
+    return effectSlots[static_cast<size_t>(index)];
 }
 
 EffectBase* EffectChain::getEffect(int index)
@@ -110,12 +326,13 @@ std::unique_ptr<juce::XmlElement> EffectChain::getStateInformation() const
     auto xml = std::make_unique<juce::XmlElement>("EffectChain");
     
     // Save each effect's state
-    for (const auto& effect : effects)
+    for (size_t i = 0; i < effects.size(); ++i)
     {
-        if (effect)
+        if (const auto& effect = effects[i])
         {
             auto effectXml = std::make_unique<juce::XmlElement>("Effect");
             effectXml->setAttribute("type", effect->getEffectType());
+            effectXml->setAttribute("slot", effectSlots[i]);
             
             // Get the effect's internal state
             auto effectState = effect->getStateInformation();
@@ -134,13 +351,13 @@ void EffectChain::setStateInformation(const juce::XmlElement& xml)
     if (!xml.hasTagName("EffectChain"))
         return;
     
-    // Clear existing chain
-    clearChain();
+    // Rebuild the whole chain before publishing so the audio thread switches over in one step
+    releaseAllSlots();
     
     // Recreate effects from XML
     for (auto* effectXml : xml.getChildIterator())
     {
-        if (effectXml->hasTagName("Effect"))
+        if (effectXml->hasTagName("Effect") && static_cast<int>(effects.size()) < maxEffects)
         {
             juce::String effectType = effectXml->getStringAttribute("type");
             
@@ -155,9 +372,231 @@ void EffectChain::setStateInformation(const juce::XmlElement& xml)
                     effect->setStateInformation(*effectState);
                 }
                 
-                // Add to chain
-                addEffect(std::move(effect));
+                prepareEffect(*effect);
+
+                // Keep the saved slot so host automation still reaches this pedal
+                const int slot = findFreeSlot(effectXml->getIntAttribute("slot", -1));
+
+                if (onSlotChanged)
+                    onSlotChanged(slot, effect.get());
+
+                effects.push_back(std::move(effect));
+                effectSlots.push_back(slot);
+                bypassDelays.push_back(createBypassDelay());
+            }
+        }
+    }
+
+    publishSnapshot();
+}
+
+//==============================================================================
+void EffectChain::publishSnapshot()
+{
+    // A snapshot still pending was never seen by the audio thread, so it can go straight away
+    delete pendingSnapshot.exchange(createSnapshot().release(), std::memory_order_acq_rel);
+
+    collectRetiredSnapshots();
+
+    // Keep reclaiming until the audio thread has picked up and retired everything
+    if (!isTimerRunning())
+        startTimer(retireIntervalMs);
+}
+
+std::unique_ptr<EffectChain::ChainSnapshot> EffectChain::createSnapshot()
+{
+    auto snapshot = std::make_unique<ChainSnapshot>();
+    snapshot->effects = effects;
+    snapshot->bypassDelays = bypassDelays;
+
+    // Group adjacent effects by the rate they were prepared for
+    size_t oversampledRuns = 0;
+
+    for (int first = 0; first < static_cast<int>(effects.size());)
+    {
+        const bool oversampled = effects[static_cast<size_t>(first)]->isHostOversampled();
+        int end = first + 1;
+
+        while (end < static_cast<int>(effects.size()) && effects[static_cast<size_t>(end)]->isHostOversampled() == oversampled)
+            ++end;
+
+        snapshot->runs.push_back({ first, end - first, oversampled ? getRunOversampler(oversampledRuns++) : nullptr });
+        first = end;
+    }
+
+    // Resolve every parameter now so the audio thread never looks anything up
+    if (parameterSource)
+    {
+        for (size_t effectIndex = 0; effectIndex < effects.size(); ++effectIndex)
+        {
+            auto* effect = effects[effectIndex].get();
+            const auto& parameters = effect->getParameterInfo();
+
+            for (int i = 0; i < static_cast<int>(parameters.size()); ++i)
+            {
+                if (auto* source = parameterSource(effectSlots[effectIndex], i))
+                {
+                    const auto& range = parameters[static_cast<size_t>(i)].range;
+
+                    // Parameters with only a few legal values (modes, switches) are never ramped
+                    const bool continuous = range.interval <= 0.0f
+                                            || (range.end - range.start) / range.interval > maxSteppedValues;
+
+                    // NaN never compares equal, so the first block always pushes the value
+                    snapshot->parameterBindings.push_back({ source, effect, i, &range, continuous,
+                                                            std::numeric_limits<float>::quiet_NaN(), 0.0f });
+                }
+            }
+        }
+    }
+
+    snapshot->parameterSource = parameterSource;
+    snapshot->rampingBindings.reserve(snapshot->parameterBindings.size());
+
+    return snapshot;
+}
+
+std::shared_ptr<Oversampler> EffectChain::getRunOversampler(size_t runIndex)
+{
+    // The run in the same position keeps its oversampler (and filter state) across edits
+    while (runOversamplers.size() <= runIndex)
+    {
+        auto oversampling = std::make_shared<Oversampler>(static_cast<size_t>(numChannels),
+                                                          static_cast<size_t>(preparedOversamplingStages),
+                                                          oversamplingFilter);
+        oversampling->initProcessing(static_cast<size_t>(samplesPerBlock));
+        runOversamplers.push_back(std::move(oversampling));
+    }
+
+    return runOversamplers[runIndex];
+}
+
+void EffectChain::updateActiveSnapshot() noexcept
+{
+    // Only swap when the replaced snapshot can be handed back; otherwise try again next block
+    if (pendingSnapshot.load(std::memory_order_relaxed) == nullptr || retireFifo.getFreeSpace() == 0)
+        return;
+
+    if (auto* next = pendingSnapshot.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        int start1, size1, start2, size2;
+        retireFifo.prepareToWrite(1, start1, size1, start2, size2);
+        jassert(size1 == 1);
+        retireQueue[static_cast<size_t>(start1)] = activeSnapshot;
+        retireFifo.finishedWrite(1);
+
+        activeSnapshot = next;
+    }
+}
+
+bool EffectChain::updateParameters() noexcept
+{
+    auto& ramping = activeSnapshot->rampingBindings;
+    ramping.clear();
+
+    for (auto& binding : activeSnapshot->parameterBindings)
+    {
+        const float value = binding.source->load(std::memory_order_relaxed);
+
+        if (value != binding.lastValue)
+        {
+            // The very first value, and stepped parameters, apply at once
+            if (binding.continuous && !std::isnan(binding.lastValue))
+            {
+                binding.startValue = binding.lastValue;
+                ramping.push_back(&binding);
+            }
+            else
+            {
+                binding.effect->setParameter(binding.index, binding.range->convertFrom0to1(value));
             }
+
+            binding.lastValue = value;
         }
     }
+
+    return !ramping.empty();
+}
+
+void EffectChain::applyParameterRamps(float fraction) noexcept
+{
+    for (auto* binding : activeSnapshot->rampingBindings)
+    {
+        const float value = binding->startValue + fraction * (binding->lastValue - binding->startValue);
+        binding->effect->setParameter(binding->index, binding->range->convertFrom0to1(value));
+    }
+}
+
+std::shared_ptr<DelayCompensator> EffectChain::createBypassDelay() const
+{
+    auto delay = std::make_shared<DelayCompensator>();
+    delay->prepare(numChannels, maxBypassDelay);
+    return delay;
+}
+
+void EffectChain::prepareEffect(EffectBase& effect)
+{
+    // Effects that want oversampling run inside a shared oversampled run, at its rate
+    const bool oversampled = preparedOversamplingStages > 0 && effect.runsAtOversampledRate();
+    const int factor = oversampled ? 1 << preparedOversamplingStages : 1;
+
+    effect.setHostOversampled(oversampled);
+    effect.setNumChannels(numChannels);
+    effect.prepare(sampleRate * factor, samplesPerBlock * factor);
+}
+
+int EffectChain::findFreeSlot(int preferredSlot) const
+{
+    auto isFree = [this](int slot)
+    {
+        return std::find(effectSlots.begin(), effectSlots.end(), slot) == effectSlots.end();
+    };
+
+    if (preferredSlot >= 0 && preferredSlot < maxEffects && isFree(preferredSlot))
+        return preferredSlot;
+
+    for (int slot = 0; slot < maxEffects; ++slot)
+    {
+        if (isFree(slot))
+            return slot;
+    }
+
+    return -1;
+}
+
+void EffectChain::releaseAllSlots()
+{
+    const auto releasedSlots = effectSlots;
+
+    effects.clear();
+    effectSlots.clear();
+    bypassDelays.clear();
+
+    if (onSlotChanged)
+    {
+        for (int slot : releasedSlots)
+            onSlotChanged(slot, nullptr);
+    }
+}
+
+void EffectChain::collectRetiredSnapshots()
+{
+    int start1, size1, start2, size2;
+    retireFifo.prepareToRead(retireFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        delete retireQueue[static_cast<size_t>(start1 + i)];
+
+    for (int i = 0; i < size2; ++i)
+        delete retireQueue[static_cast<size_t>(start2 + i)];
+
+    retireFifo.finishedRead(size1 + size2);
+}
+
+void EffectChain::timerCallback()
+{
+    collectRetiredSnapshots();
+
+    if (pendingSnapshot.load() == nullptr && retireFifo.getNumReady() == 0)
+        stopTimer();
 }
@@ -2,19 +2,55 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <memory>
 #include "../effects/EffectBase.h"
+#include "../dsp/Oversampler.h"
+#include "../dsp/DelayCompensator.h"
 
 /**
  * Manages a chain of guitar effects.
  * Handles adding, removing, reordering, and processing audio through multiple effects.
+ *
+ * The chain is edited on the message thread and processed on the audio thread
+ * without the two ever sharing a mutable container. Every edit builds a new
+ * immutable ChainSnapshot, prepares any new effects, and publishes it with an
+ * atomic pointer swap. The audio thread adopts the latest snapshot at the start
+ * of a block and hands the one it replaced back through a lock-free retire
+ * queue, so snapshots (and any effects only they still reference) are always
+ * freed on the message thread.
+ *
+ * Each snapshot also carries a flat parameter binding table, resolved once when
+ * the snapshot is built. Per block, the audio thread only walks that table and
+ * forwards values that moved to EffectBase::setParameter(). When a continuous
+ * parameter moved, the block is split into automationQuantum-sized ranges and
+ * the value is stepped from its old to its new setting across them, so host
+ * automation is not quantised to the host block size. Blocks without
+ * automation still go through every effect in one pass.
+ *
+ * Adjacent effects that run at an oversampled rate (drive pedals) form runs
+ * that share one oversampler: the chain upsamples once before the run,
+ * processes every pedal in it at the higher rate and downsamples once after,
+ * so stacking more drive pedals adds neither filter cost nor latency. Those
+ * effects are prepared at the oversampled rate and do not resample themselves.
+ *
+ * The chain reports its total latency and tail for plugin delay compensation.
+ * A bypassed effect with latency passes its input through a delay of the same
+ * length, so bypassing a pedal does not shift the chain's timing.
+ *
+ * Every effect occupies one of maxEffects fixed slots for as long as it is in
+ * the chain. Slots follow the effect when it is moved and are saved with the
+ * chain, so the host parameters behind a slot keep driving the same pedal.
  */
-class EffectChain
+class EffectChain : private juce::Timer
 {
 public:
     EffectChain();
-    ~EffectChain();
+    ~EffectChain() override;
     
     //==============================================================================
     // DSP Processing
@@ -23,8 +59,39 @@ public:
      * Prepares all effects in the chain for playback.
      * @param sampleRate The sample rate to prepare for
      * @param samplesPerBlock The maximum number of samples per block
+     * @param numChannels The number of channels processBlock() will be given
      */
-    void prepare(double sampleRate, int samplesPerBlock);
+    void prepare(double sampleRate, int samplesPerBlock, int numChannels = 2);
+
+    /**
+     * Sets how far runs of adjacent oversampled effects are oversampled, as a
+     * number of 2x stages (0 to maxOversamplingStages). With 0 the chain does not
+     * oversample and each effect oversamples by itself. Takes effect at the next prepare().
+     * @param numStages The number of 2x stages
+     */
+    void setOversampling(int numStages) noexcept;
+
+    /** Returns the oversampling last set with setOversampling(), prepared or not. */
+    int getOversampling() const noexcept { return oversamplingStages; }
+
+    /**
+     * Sets the filter design of the shared oversampling (message thread).
+     * Takes effect with the next snapshot; the rate does not change, so nothing
+     * is re-prepared and the switch is safe while processing.
+     * @param newFilterType The filter design
+     */
+    void setOversamplingFilter(Oversampler::FilterType newFilterType);
+
+    /**
+     * Returns the chain's total latency in samples at the host rate (message thread):
+     * every effect's latency, bypassed ones included, plus each oversampled run's conversion.
+     */
+    int getLatencySamples() const;
+
+    /**
+     * Returns the chain's total tail in samples at the host rate (message thread).
+     */
+    int getTailSamples() const;
     
     /**
      * Resets all effects in the chain.
@@ -34,18 +101,60 @@ public:
     /**
      * Processes an audio buffer through the entire effect chain.
      * Each effect processes the buffer sequentially.
+     * Audio thread only: never locks, allocates or frees memory.
      * @param buffer The audio buffer to process (modified in-place)
      */
     void processBlock(juce::AudioBuffer<float>& buffer);
     
     //==============================================================================
-    // Chain Management
+    // Parameter Binding (message thread)
+
+    /**
+     * Resolves the host parameter that drives one effect parameter.
+     * Receives the effect's slot and the parameter's index in getParameterInfo(),
+     * and returns the normalised (0 to 1) value to read each block, or nullptr if unbound.
+     */
+    using ParameterSource = std::function<std::atomic<float>*(int slot, int parameterIndex)>;
+
+    /**
+     * Sets the lookup used to bind effect parameters and rebinds the chain.
+     * Every snapshot keeps a copy of the lookup, so anything it captures by value
+     * lives until no snapshot bound through it can still be processed.
+     * @param newSource The parameter lookup
+     */
+    void setParameterSource(ParameterSource newSource);
+
+    /**
+     * Re-resolves every effect parameter and publishes the result.
+     * Call after the parameters behind the ParameterSource have changed.
+     */
+    void rebindParameters();
+
+    /**
+     * Called on the message thread whenever a slot is taken or released,
+     * before the audio thread can see the change. The effect is nullptr
+     * when the slot has been released.
+     */
+    std::function<void(int slot, EffectBase* effect)> onSlotChanged;
+
+    //==============================================================================
+    // Chain Management (message thread)
+
+    /** Samples between parameter updates while automation is moving. */
+    static constexpr int automationQuantum = 32;
     
+    /** The number of fixed slots, and so the maximum length of the chain. */
+    static constexpr int maxEffects = 16;
+
+    /** The highest shared oversampling, in 2x stages (16x). */
+    static constexpr int maxOversamplingStages = 4;
+
     /**
-     * Adds an effect to the end of the chain.
+     * Adds an effect to the end of the chain, in the first free slot.
      * @param effect The effect to add (takes ownership)
+     * @return True if the effect was added, false if every slot is taken
      */
-    void addEffect(std::unique_ptr<EffectBase> effect);
+    bool addEffect(std::unique_ptr<EffectBase> effect);
     
     /**
      * Removes an effect from the chain at the specified index.
@@ -71,6 +180,13 @@ public:
      * Returns the number of effects in the chain.
      */
     int getNumEffects() const { return static_cast<int>(effects.size()); }
+
+    /**
+     * Returns the slot occupied by the effect at the specified index.
+     * @param index The index of the effect
+     * @return The slot, or -1 if index is out of range
+     */
+    int getEffectSlot(int index) const;
     
     /**
      * Returns a pointer to the effect at the specified index.
@@ -104,9 +220,136 @@ public:
     void setStateInformation(const juce::XmlElement& xml);
     
 private:
-    std::vector<std::unique_ptr<EffectBase>> effects;
+    /**
+     * Immutable view of the chain handed to the audio thread.
+     * Shares ownership of its effects so a removed effect stays alive until
+     * the last snapshot referencing it has been reclaimed.
+     */
+    struct ChainSnapshot
+    {
+        /**
+         * One effect parameter fed from one host parameter.
+         * lastValue and startValue are only touched by the audio thread once the snapshot is live.
+         */
+        struct ParameterBinding
+        {
+            std::atomic<float>* source;
+            EffectBase* effect;
+            int index;
+            const juce::NormalisableRange<float>* range;
+            bool continuous;    // Ramped across a block; stepped parameters (modes, switches) jump
+            float lastValue;
+            float startValue;   // Value at the start of the current block's ramp
+        };
+
+        /**
+         * Consecutive effects processed at the same rate. Oversampled runs share
+         * their oversampler with the run in the same position of later snapshots.
+         */
+        struct Run
+        {
+            int firstEffect;
+            int numEffects;
+            std::shared_ptr<Oversampler> oversampling;   // Null for host-rate runs
+        };
+
+        std::vector<std::shared_ptr<EffectBase>> effects;
+        std::vector<std::shared_ptr<DelayCompensator>> bypassDelays;   // One per effect
+        std::vector<Run> runs;
+        std::vector<ParameterBinding> parameterBindings;
+
+        // The lookup the bindings came from, holding on to whatever owns their sources
+        // until the audio thread has let go of this snapshot
+        ParameterSource parameterSource;
+
+        // Bindings ramping in the current block (capacity reserved, so never reallocates)
+        std::vector<ParameterBinding*> rampingBindings;
+    };
+
+    /** Builds a snapshot of the current chain and publishes it to the audio thread. */
+    void publishSnapshot();
+
+    /** Builds a snapshot of the current chain: its runs and parameter bindings. */
+    std::unique_ptr<ChainSnapshot> createSnapshot();
+
+    /** Returns the shared oversampler for the nth oversampled run, creating it if needed. */
+    std::shared_ptr<Oversampler> getRunOversampler(size_t runIndex);
+
+    /** Audio thread: adopts the most recently published snapshot, if any. */
+    void updateActiveSnapshot() noexcept;
+
+    /**
+     * Audio thread: forwards every bound parameter that changed since the last block,
+     * except continuous ones, which are queued for applyParameterRamps().
+     * @return True if any parameter needs ramping across this block
+     */
+    bool updateParameters() noexcept;
+
+    /** Audio thread: sets every ramping parameter to the given fraction of its move. */
+    void applyParameterRamps(float fraction) noexcept;
+
+    /** Audio thread: runs a range of the buffer through every active effect. */
+    void processEffects(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /**
+     * Audio thread: runs one effect over a range of the buffer. A bypassed effect
+     * with latency delays the range by that latency instead.
+     */
+    static void processEffect(EffectBase& effect, DelayCompensator& bypassDelay, juce::AudioBuffer<float>& buffer,
+                              int startSample, int numSamples);
+
+    /** Audio thread: upsamples a range once, runs it through the run's effects and downsamples it. */
+    void processOversampledRun(const ChainSnapshot::Run& run, juce::AudioBuffer<float>& buffer,
+                               int startSample, int numSamples);
+
+    /** Prepares an effect with the chain's current playback settings. */
+    void prepareEffect(EffectBase& effect);
+
+    /** Creates a bypass delay for the chain's current channel count. */
+    std::shared_ptr<DelayCompensator> createBypassDelay() const;
+
+    /** Returns the preferred slot if it is free, otherwise the first free slot, or -1. */
+    int findFreeSlot(int preferredSlot = -1) const;
+
+    /** Releases every slot and empties the chain (without publishing). */
+    void releaseAllSlots();
+
+    /** Frees snapshots the audio thread has finished with. */
+    void collectRetiredSnapshots();
+
+    void timerCallback() override;
+
+    // Message thread view of the chain, in processing order
+    std::vector<std::shared_ptr<EffectBase>> effects;
+    std::vector<int> effectSlots;   // Slot of each entry in effects
+    std::vector<std::shared_ptr<DelayCompensator>> bypassDelays;   // Bypass delay of each entry in effects
+    ParameterSource parameterSource;
+
+    // One oversampler per oversampled run position, built for the prepared settings
+    std::vector<std::shared_ptr<Oversampler>> runOversamplers;
+    Oversampler::FilterType oversamplingFilter = Oversampler::FilterType::IIR;
+
+    // Owned by the audio thread between swaps (never null)
+    ChainSnapshot* activeSnapshot = nullptr;
+
+    // Published by the message thread, taken by the audio thread
+    std::atomic<ChainSnapshot*> pendingSnapshot { nullptr };
+
+    static constexpr float maxSteppedValues = 16.0f;   // Fewer legal values than this: stepped, not ramped
+    static constexpr size_t maxRunChannels = 32;       // As many as an AudioBuffer refers to without allocating
+    static constexpr int maxBypassDelay = 2048;        // Longest latency a bypassed effect is compensated for
+
+    // Snapshots replaced on the audio thread, waiting to be freed on the message thread
+    static constexpr int retireQueueSize = 32;
+    static constexpr int retireIntervalMs = 100;
+    juce::AbstractFifo retireFifo { retireQueueSize };
+    std::array<ChainSnapshot*, retireQueueSize> retireQueue {};
+
     double sampleRate = 44100.0;
     int samplesPerBlock = 512;
+    int numChannels = 2;
+    int oversamplingStages = 1;           // Requested
+    int preparedOversamplingStages = 0;   // What the effects were prepared for
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectChain)
 };
@@ -192,7 +192,7 @@ void PedalBoardEditor::buttonClicked(juce::Button* button)
     else if (button == &clearChainButton)
     {
         // Clear the entire effect chain
-        processor.getEffectChain().clearChain();
+        processor.clearEffectChain();
         rebuildPedalComponents();
     }
 }
@@ -214,7 +214,7 @@ void PedalBoardEditor::rebuildPedalComponents()
     {
         if (auto* effect = chain.getEffect(i))
         {
-            juce::String prefix = "effect" + juce::String(i) + "_";
+            juce::String prefix = "slot" + juce::String(chain.getEffectSlot(i)) + "_";
             auto* pedal = pedalComponents.add(new PedalComponent(effect, processor.getAPVTS(), prefix, i));
             pedalContainer.addAndMakeVisible(pedal);
         }
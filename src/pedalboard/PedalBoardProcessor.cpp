@@ -1,10 +1,6 @@
 #include "PedalBoardProcessor.h"
 #include "PedalBoardEditor.h"
 #include "EffectFactory.h"
-#include "../effects/Fuzz.h"
-#include "../effects/Compressor.h"
-#include "../effects/Reverb.h"
-#include "../effects/Chorus.h"
 
 PedalBoardProcessor::PedalBoardProcessor()
     : AudioProcessor(BusesProperties()
@@ -16,10 +12,24 @@ PedalBoardProcessor::PedalBoardProcessor()
         *this, nullptr, "Parameters", createParameterLayout());
     
     updateParameterPointers();
+
+    // Effect parameters are resolved once per chain edit, never per block
+    effectChain.onSlotChanged = [this](int slot, EffectBase* effect) { slotChanged(slot, effect); };
+    effectChain.setParameterSource([this](int slot, int parameterIndex)
+    {
+        return apvts->getRawParameterValue(getSlotParameterID(slot, parameterIndex));
+    });
+
+    // The latency mode swaps oversampling filters and the oversampling re-prepares the chain,
+    // which both allocate, so they are applied on the message thread
+    updateLatencyMode();
+    effectChain.setOversampling(getOversamplingStages());
+    startTimer(latencyCheckIntervalMs);
 }
 
 PedalBoardProcessor::~PedalBoardProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -31,12 +41,27 @@ const juce::String PedalBoardProcessor::getName() const
 //==============================================================================
 void PedalBoardProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    effectChain.prepare(sampleRate, samplesPerBlock);
+    updateLatencyMode();
+    effectChain.setOversampling(getOversamplingStages());
+    effectChain.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+
+    inputGain.prepare(sampleRate, samplesPerBlock);
+    outputGain.prepare(sampleRate, samplesPerBlock);
+    bypassDelay.prepare(getTotalNumOutputChannels(), maxBypassDelay);
+
+    updateLatency();
+
+    if (inputGainParam != nullptr)
+        inputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(inputGainParam->load()));
+
+    if (outputGainParam != nullptr)
+        outputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(outputGainParam->load()));
 }
 
 void PedalBoardProcessor::releaseResources()
 {
     effectChain.reset();
+    bypassDelay.reset();
 }
 
 bool PedalBoardProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -62,33 +87,54 @@ void PedalBoardProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::M
     
     if (isBypassed)
     {
-        // When bypassed, just pass audio through
+        // When bypassed, pass audio through as late as the board's output would be
+        processBypassed(buffer);
         return;
     }
     
-    // Update effect parameters from APVTS before processing
-    updateEffectParametersFromAPVTS();
-    
+    juce::dsp::AudioBlock<float> block(buffer);
+
+    // Keep the bypass delay's history current so a switch to bypass lines up straight away
+    bypassDelay.setDelay(reportedLatency.load());
+    bypassDelay.write(block);
+
     // Apply input gain
     if (inputGainParam != nullptr)
     {
         float inputGainDb = *inputGainParam;
-        float inputGainLinear = juce::Decibels::decibelsToGain(inputGainDb);
-        buffer.applyGain(inputGainLinear);
+        inputGain.setTargetValue(juce::Decibels::decibelsToGain(inputGainDb));
+        inputGain.applyGain(block);
     }
     
-    // Process through effect chain
+    // Process through effect chain (also applies any parameter changes)
     effectChain.processBlock(buffer);
     
     // Apply output gain
     if (outputGainParam != nullptr)
     {
         float outputGainDb = *outputGainParam;
-        float outputGainLinear = juce::Decibels::decibelsToGain(outputGainDb);
-        buffer.applyGain(outputGainLinear);
+        outputGain.setTargetValue(juce::Decibels::decibelsToGain(outputGainDb));
+        outputGain.applyGain(block);
     }
 }
 
+void PedalBoardProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    processBypassed(buffer);
+}
+
+void PedalBoardProcessor::processBypassed(juce::AudioBuffer<float>& buffer)
+{
+    bypassDelay.setDelay(reportedLatency.load());
+    bypassDelay.process(juce::dsp::AudioBlock<float>(buffer));
+}
+
+juce::AudioProcessorParameter* PedalBoardProcessor::getBypassParameter() const
+{
+    return apvts->getParameter("globalBypass");
+}
+
 //==============================================================================
 juce::AudioProcessorEditor* PedalBoardProcessor::createEditor()
 {
@@ -134,20 +180,13 @@ void PedalBoardProcessor::setStateInformation(const void* data, int sizeInBytes)
                 apvts->replaceState(valueTree);
         }
         
-        // Restore effect chain
+        // Restore effect chain (each effect refills its slot's parameters)
         if (auto* chainXml = xml->getChildByName("EffectChain"))
-        {
             effectChain.setStateInformation(*chainXml);
-            
-            // After loading the chain, we need to rebuild parameters
-            // This should be done on the message thread
-            juce::MessageManager::callAsync([this]()
-            {
-                rebuildParameterLayout();
-            });
-        }
-        
-        updateParameterPointers();
+
+        updateLatencyMode();
+        updateOversampling();
+        updateLatency();
     }
 }
 
@@ -158,27 +197,28 @@ void PedalBoardProcessor::addEffectToChain(const juce::String& effectType)
     auto effect = EffectFactory::createEffect(effectType);
     
     if (effect)
-    {
         effectChain.addEffect(std::move(effect));
-        
-        // Rebuild parameter layout to include new effect's parameters
-        rebuildParameterLayout();
-    }
+
+    updateLatency();
 }
 
 void PedalBoardProcessor::removeEffectFromChain(int index)
 {
-    if (effectChain.removeEffect(index))
-    {
-        // Rebuild parameter layout
-        rebuildParameterLayout();
-    }
+    effectChain.removeEffect(index);
+    updateLatency();
 }
 
 void PedalBoardProcessor::moveEffectInChain(int fromIndex, int toIndex)
 {
     effectChain.moveEffect(fromIndex, toIndex);
-    // No need to rebuild parameters for reordering
+    // No need to rebuild parameters for reordering, but runs of oversampled pedals may have regrouped
+    updateLatency();
+}
+
+void PedalBoardProcessor::clearEffectChain()
+{
+    effectChain.clearChain();
+    updateLatency();
 }
 
 //==============================================================================
@@ -206,60 +246,94 @@ juce::AudioProcessorValueTreeState::ParameterLayout PedalBoardProcessor::createP
         "Global Bypass",
         false));
     
-    // Add parameters for each effect in the chain
-    int effectIndex = 0;
-    for (int i = 0; i < effectChain.getNumEffects(); ++i)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "latencyMode",
+        "Latency Mode",
+        juce::StringArray { "Studio", "Live" },
+        static_cast<int>(LatencyMode::Studio)));
+
+    // Shared oversampling of drive pedal runs, as a number of 2x stages
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling",
+        "Oversampling",
+        juce::StringArray { "Off", "2x", "4x", "8x", "16x" },
+        1));
+
+    // Slot parameters are normalised; their text is shown in the slot effect's own units
+    for (int slot = 0; slot < EffectChain::maxEffects; ++slot)
     {
-        if (auto* effect = effectChain.getEffect(i))
+        for (int index = 0; index < parametersPerSlot; ++index)
         {
-            juce::String prefix = "effect" + juce::String(effectIndex) + "_";
-            effect->addParametersToLayout(layout, prefix);
-            effectIndex++;
+            auto findInfo = [this, slot, index]() -> const EffectBase::ParameterInfo*
+            {
+                auto* parameters = slotParameterInfo[static_cast<size_t>(slot)].load();
+
+                if (parameters == nullptr || index >= static_cast<int>(parameters->size()))
+                    return nullptr;
+
+                return &(*parameters)[static_cast<size_t>(index)];
+            };
+
+            auto attributes = juce::AudioParameterFloatAttributes()
+                .withStringFromValueFunction([findInfo](float value, int)
+                {
+                    if (auto* info = findInfo())
+                        return juce::String(info->range.convertFrom0to1(value), 2);
+
+                    return juce::String("-");
+                })
+                .withValueFromStringFunction([findInfo](const juce::String& text)
+                {
+                    if (auto* info = findInfo())
+                        return info->range.convertTo0to1(info->range.snapToLegalValue(text.getFloatValue()));
+
+                    return text.getFloatValue();
+                });
+
+            layout.add(std::make_unique<juce::AudioParameterFloat>(
+                getSlotParameterID(slot, index),
+                "Slot " + juce::String(slot + 1) + " Param " + juce::String(index + 1),
+                juce::NormalisableRange<float>(0.0f, 1.0f),
+                0.0f,
+                attributes));
         }
     }
     
     return layout;
 }
 
-void PedalBoardProcessor::rebuildParameterLayout()
+juce::String PedalBoardProcessor::getSlotParameterID(int slot, int index)
 {
-    // Store current state
-    auto currentState = apvts->copyState();
+    return "slot" + juce::String(slot) + "_param" + juce::String(index);
+}
     
-    // Create new APVTS with updated parameter layout
-    apvts = std::make_unique<juce::AudioProcessorValueTreeState>(
-        *this, nullptr, "Parameters", createParameterLayout());
+void PedalBoardProcessor::slotChanged(int slot, EffectBase* effect)
+{
+    auto& infoSlot = slotParameterInfo[static_cast<size_t>(slot)];
     
-    // Restore as much state as possible
-    // Global parameters should be preserved
-    if (currentState.isValid())
+    if (effect == nullptr)
     {
-        for (auto param : apvts->state)
-        {
-            juce::String paramId = param.getProperty("id").toString();
-            if (currentState.hasProperty(paramId))
-            {
-                param.setProperty("value", currentState.getProperty(paramId), nullptr);
-            }
-        }
+        infoSlot.store(nullptr);
     }
-    
-    // Link effect parameters
-    int effectIndex = 0;
-    for (int i = 0; i < effectChain.getNumEffects(); ++i)
+    else
     {
-        if (auto* effect = effectChain.getEffect(i))
+        const auto& parameters = effect->getParameterInfo();
+        jassert(static_cast<int>(parameters.size()) <= parametersPerSlot);
+        infoSlot.store(&parameters);
+
+        // Start the slot's host parameters from the effect's own values
+        for (int i = 0; i < juce::jmin(static_cast<int>(parameters.size()), parametersPerSlot); ++i)
         {
-            juce::String prefix = "effect" + juce::String(effectIndex) + "_";
-            effect->linkParameters(*apvts, prefix);
-            effectIndex++;
+            if (auto* parameter = apvts->getParameter(getSlotParameterID(slot, i)))
+            {
+                const auto& range = parameters[static_cast<size_t>(i)].range;
+                parameter->setValueNotifyingHost(range.convertTo0to1(effect->getParameter(i)));
+            }
         }
     }
     
-    updateParameterPointers();
-    
-    // Notify host that parameters have changed
-    updateHostDisplay();
+    // Parameter text now reads in different units
+    updateHostDisplay(juce::AudioProcessor::ChangeDetails().withParameterInfoChanged(true));
 }
 
 void PedalBoardProcessor::updateParameterPointers()
@@ -267,66 +341,67 @@ void PedalBoardProcessor::updateParameterPointers()
     inputGainParam = apvts->getRawParameterValue("inputGain");
     outputGainParam = apvts->getRawParameterValue("outputGain");
     globalBypassParam = apvts->getRawParameterValue("globalBypass");
+    latencyModeParam = apvts->getRawParameterValue("latencyMode");
+    oversamplingParam = apvts->getRawParameterValue("oversampling");
+}
+
+void PedalBoardProcessor::updateLatencyMode()
+{
+    if (latencyModeParam == nullptr)
+        return;
+
+    const auto mode = static_cast<LatencyMode>(juce::roundToInt(latencyModeParam->load()));
+    effectChain.setOversamplingFilter(mode == LatencyMode::Live ? Oversampler::FilterType::MinimumPhase
+                                                                : Oversampler::FilterType::LinearPhase);
+}
+
+int PedalBoardProcessor::getOversamplingStages() const
+{
+    if (oversamplingParam == nullptr)
+        return effectChain.getOversampling();
+
+    return juce::jlimit(0, EffectChain::maxOversamplingStages, juce::roundToInt(oversamplingParam->load()));
 }
 
-void PedalBoardProcessor::updateEffectParametersFromAPVTS()
+void PedalBoardProcessor::updateOversampling()
 {
-    // Update each effect's parameters from APVTS
-    int effectIndex = 0;
-    for (int i = 0; i < effectChain.getNumEffects(); ++i)
+    const int stages = getOversamplingStages();
+
+    if (stages == effectChain.getOversampling())
+        return;
+
+    effectChain.setOversampling(stages);
+
+    // Every drive pedal runs at the new rate, so the chain has to be prepared again.
+    // Processing is held off meanwhile, as prepare() must not overlap processBlock().
+    if (getSampleRate() > 0.0)
     {
-        if (auto* effect = effectChain.getEffect(i))
-        {
-            juce::String prefix = "effect" + juce::String(effectIndex) + "_";
-            
-            if (effect->getEffectType() == "fuzz")
-            {
-                if (auto* gainParam = apvts->getRawParameterValue(prefix + "gain"))
-                    dynamic_cast<Fuzz*>(effect)->setGain(*gainParam);
-                if (auto* toneParam = apvts->getRawParameterValue(prefix + "tone"))
-                    dynamic_cast<Fuzz*>(effect)->setTone(*toneParam);
-                if (auto* levelParam = apvts->getRawParameterValue(prefix + "level"))
-                    dynamic_cast<Fuzz*>(effect)->setLevel(*levelParam);
-            }
-            else if (effect->getEffectType() == "compressor")
-            {
-                if (auto* thresholdParam = apvts->getRawParameterValue(prefix + "threshold"))
-                    dynamic_cast<Compressor*>(effect)->setThreshold(*thresholdParam);
-                if (auto* ratioParam = apvts->getRawParameterValue(prefix + "ratio"))
-                    dynamic_cast<Compressor*>(effect)->setRatio(*ratioParam);
-                if (auto* attackParam = apvts->getRawParameterValue(prefix + "attack"))
-                    dynamic_cast<Compressor*>(effect)->setAttack(*attackParam);
-                if (auto* releaseParam = apvts->getRawParameterValue(prefix + "release"))
-                    dynamic_cast<Compressor*>(effect)->setRelease(*releaseParam);
-                if (auto* makeupParam = apvts->getRawParameterValue(prefix + "makeupGain"))
-                    dynamic_cast<Compressor*>(effect)->setMakeupGain(*makeupParam);
-            }
-            else if (effect->getEffectType() == "reverb")
-            {
-                if (auto* roomSizeParam = apvts->getRawParameterValue(prefix + "roomSize"))
-                    dynamic_cast<Reverb*>(effect)->setRoomSize(*roomSizeParam);
-                if (auto* dampingParam = apvts->getRawParameterValue(prefix + "damping"))
-                    dynamic_cast<Reverb*>(effect)->setDamping(*dampingParam);
-                if (auto* wetLevelParam = apvts->getRawParameterValue(prefix + "wetLevel"))
-                    dynamic_cast<Reverb*>(effect)->setWetLevel(*wetLevelParam);
-                if (auto* widthParam = apvts->getRawParameterValue(prefix + "width"))
-                    dynamic_cast<Reverb*>(effect)->setWidth(*widthParam);
-            }
-            else if (effect->getEffectType() == "chorus")
-            {
-                if (auto* rateParam = apvts->getRawParameterValue(prefix + "rate"))
-                    dynamic_cast<Chorus*>(effect)->setRate(*rateParam);
-                if (auto* depthParam = apvts->getRawParameterValue(prefix + "depth"))
-                    dynamic_cast<Chorus*>(effect)->setDepth(*depthParam);
-                if (auto* mixParam = apvts->getRawParameterValue(prefix + "mix"))
-                    dynamic_cast<Chorus*>(effect)->setMix(*mixParam);
-            }
-            
-            effectIndex++;
-        }
+        suspendProcessing(true);
+        effectChain.prepare(getSampleRate(), getBlockSize(), getTotalNumOutputChannels());
+        suspendProcessing(false);
     }
 }
 
+void PedalBoardProcessor::updateLatency()
+{
+    // setLatencySamples() only notifies the host when the value actually changed
+    const int latency = effectChain.getLatencySamples();
+    jassert(latency <= maxBypassDelay);
+    setLatencySamples(latency);
+    reportedLatency.store(latency);
+
+    const double sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    tailLengthSeconds.store(effectChain.getTailSamples() / sampleRate);
+}
+
+void PedalBoardProcessor::timerCallback()
+{
+    // Also catches latency and tail changes from inside effects (oversampling tiers, room size)
+    updateLatencyMode();
+    updateOversampling();
+    updateLatency();
+}
+
 //==============================================================================
 // This creates new instances of the plugin
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -7,8 +7,34 @@
 /**
  * Main audio processor for the OpenGuitar Pedal Board VST3 plugin.
  * Manages a chain of guitar effects with dynamic parameter management.
+ *
+ * The host sees a fixed pool of parameters: a few globals plus
+ * parametersPerSlot generic parameters for each of the chain's slots.
+ * Adding or removing a pedal only rebinds a slot, so the parameter tree
+ * is created once and never rebuilt. The price is that a slot parameter's
+ * default is fixed when the tree is created: it is normalised 0 whatever
+ * pedal sits in the slot, so a host's "reset to default" sends the pedal's
+ * knob to its minimum. The pedal knobs double-click back to the pedal's own
+ * default instead.
+ *
+ * The global oversampling sets how far the chain oversamples runs of drive
+ * pedals, from Off to 16x. Those pedals then run at that rate and Fuzz's own
+ * oversampling parameters are ignored. With Off, only Fuzz oversamples, by
+ * its own setting; Big Muff and Orange run at the host rate, where their
+ * ADAA qualities are the remaining defence against aliasing.
+ *
+ * The global latency mode picks the filters of the chain's shared
+ * oversampling: Studio uses linear-phase filters, and Live uses
+ * minimum-phase ones that add well under a millisecond, for players who
+ * monitor through the pedalboard.
+ *
+ * The chain's latency and tail are reported to the host whenever the chain
+ * changes, so multi-track sessions stay phase-aligned. While the board is
+ * bypassed, globally or by the host, its input is delayed by the same
+ * latency.
  */
-class PedalBoardProcessor : public juce::AudioProcessor
+class PedalBoardProcessor : public juce::AudioProcessor,
+                            private juce::Timer
 {
 public:
     PedalBoardProcessor();
@@ -21,6 +47,8 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     //==============================================================================
     // Editor
@@ -35,7 +63,7 @@ public:
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override { return tailLengthSeconds.load(); }
 
     //==============================================================================
     // Programs
@@ -74,6 +102,11 @@ public:
      */
     void moveEffectInChain(int fromIndex, int toIndex);
     
+    /**
+     * Removes every effect from the chain.
+     */
+    void clearEffectChain();
+
     /**
      * Returns the effect chain for UI access.
      */
@@ -84,6 +117,23 @@ public:
      */
     juce::AudioProcessorValueTreeState& getAPVTS() { return *apvts; }
 
+    /** The number of host parameters reserved for each effect slot. */
+    static constexpr int parametersPerSlot = 8;
+
+    /**
+     * Returns the ID of a slot parameter.
+     * @param slot The effect slot
+     * @param index The parameter's index in the slot effect's getParameterInfo()
+     */
+    static juce::String getSlotParameterID(int slot, int index);
+
+    /** Trade-off between latency and phase accuracy for the whole board. */
+    enum class LatencyMode
+    {
+        Studio,   // Linear-phase oversampling filters
+        Live      // Minimum-phase oversampling filters, for monitoring through the board
+    };
+
 private:
     //==============================================================================
     // Core components
@@ -95,32 +145,73 @@ private:
     std::atomic<float>* inputGainParam = nullptr;
     std::atomic<float>* outputGainParam = nullptr;
     std::atomic<float>* globalBypassParam = nullptr;
+    std::atomic<float>* latencyModeParam = nullptr;
+    std::atomic<float>* oversamplingParam = nullptr;
     
+    // The chain's tail as last reported, read by the host from any thread
+    std::atomic<double> tailLengthSeconds { 0.0 };
+
+    // The chain's latency as last reported, and the delay that applies it to the bypassed signal
+    std::atomic<int> reportedLatency { 0 };
+    DelayCompensator bypassDelay;
+    static constexpr int maxBypassDelay = 8192;   // Longest chain latency the bypass is compensated for
+
+    // Linear input and output gains, ramped when the host moves them
+    SmoothedParameter inputGain { 1.0f };
+    SmoothedParameter outputGain { 1.0f };
+
+    // Parameter info of the effect in each slot, read when the host asks for value text
+    std::array<std::atomic<const std::vector<EffectBase::ParameterInfo>*>, EffectChain::maxEffects> slotParameterInfo {};
+
     //==============================================================================
     // Parameter management
     
     /**
-     * Creates the initial parameter layout with global parameters.
+     * Creates the parameter layout: global parameters plus every slot parameter.
      */
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
     /**
-     * Rebuilds the entire parameter tree when effects are added/removed.
-     * This is called on the message thread, not the audio thread.
+     * Points a slot's parameters at a newly placed effect (or at nothing).
+     * Called by the effect chain on the message thread.
      */
-    void rebuildParameterLayout();
+    void slotChanged(int slot, EffectBase* effect);
     
     /**
-     * Updates parameter pointers after rebuild.
+     * Caches the global parameters' raw value pointers (constructor only).
      */
     void updateParameterPointers();
     
     /**
-     * Updates effect parameters from APVTS values.
-     * Called in processBlock to sync UI changes to effects.
+     * Passes the latency mode parameter on to the effect chain (message thread).
      */
-    void updateEffectParametersFromAPVTS();
-    
+    void updateLatencyMode();
+
+    /**
+     * Returns the oversampling parameter as a number of 2x stages.
+     */
+    int getOversamplingStages() const;
+
+    /**
+     * Passes the oversampling parameter on to the effect chain and, if it moved
+     * while prepared, prepares the chain again at the new rate (message thread).
+     */
+    void updateOversampling();
+
+    /**
+     * Reports the chain's current latency and tail to the host (message thread).
+     */
+    void updateLatency();
+
+    /**
+     * Passes the input through, delayed by the reported latency (audio thread).
+     */
+    void processBypassed(juce::AudioBuffer<float>& buffer);
+
+    void timerCallback() override;
+
+    static constexpr int latencyCheckIntervalMs = 100;
+
     //==============================================================================
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PedalBoardProcessor)
@@ -27,6 +27,35 @@ PedalComponent::PedalComponent(EffectBase* eff,
 
 PedalComponent::~PedalComponent()
 {
+    if (observingEffect)
+        effect->removeObserver();
+}
+
+juce::String PedalComponent::getParameterID(const juce::String& effectParameterID) const
+{
+    // Host parameters are numbered by the parameter's position in the effect's info
+    const auto& parameters = effect->getParameterInfo();
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        if (parameters[i].id == effectParameterID)
+            return paramPrefix + "param" + juce::String(static_cast<int>(i));
+    }
+
+    jassertfalse;
+    return {};
+}
+
+void PedalComponent::attachSlider(juce::Slider& slider, const juce::String& effectParameterID)
+{
+    sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, getParameterID(effectParameterID), slider));
+
+    // Slot parameters are generic and all default to 0, so double-click returns to the effect's own default
+    for (const auto& info : effect->getParameterInfo())
+    {
+        if (info.id == effectParameterID)
+            slider.setDoubleClickReturnValue(true, info.range.convertTo0to1(info.defaultValue));
+    }
 }
 
 //==============================================================================
@@ -74,6 +103,47 @@ void PedalComponent::paint(juce::Graphics& g)
     drawScrew(bounds.getRight() - screwInset, bounds.getY() + screwInset);
     drawScrew(bounds.getX() + screwInset, bounds.getBottom() - screwInset);
     drawScrew(bounds.getRight() - screwInset, bounds.getBottom() - screwInset);
+
+    if (showStrobe && tunerArrowLabel)
+        paintStrobe(g, tunerArrowLabel->getBounds().toFloat());
+}
+
+void PedalComponent::paintStrobe(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRoundedRectangle(area, 4.0f);
+
+    if (!strobeDisplay.isLocked())
+        return;
+
+    // One row per harmonic. Higher harmonics use finer stripes so every row drifts
+    // at the same speed, left when flat and right when sharp, and stands still in tune.
+    const float basePeriod = 24.0f;
+    const float rowHeight = area.getHeight() / Tuner::numStrobeBands;
+    const float twoPi = juce::MathConstants<float>::twoPi;
+    const auto stripeColour = std::abs(strobeDisplay.cents) < 1.0f ? juce::Colours::green : juce::Colours::orange;
+
+    g.saveState();
+    g.reduceClipRegion(area.toNearestInt());
+
+    for (int h = 0; h < Tuner::numStrobeBands; ++h)
+    {
+        const float level = strobeDisplay.levels[static_cast<size_t>(h)];
+        if (level <= 0.0f)
+            continue;
+
+        const float period = basePeriod / (h + 1);
+        const float phase = strobeDisplay.phases[static_cast<size_t>(h)] / twoPi;
+        const float offset = (phase - std::floor(phase)) * period;
+        const auto row = area.withY(area.getY() + h * rowHeight).withHeight(rowHeight).reduced(0.0f, 2.0f);
+
+        g.setColour(stripeColour.withAlpha(0.3f + 0.7f * level));
+
+        for (float x = row.getX() - period + offset; x < row.getRight(); x += period)
+            g.fillRect(x, row.getY(), period * 0.5f, row.getHeight());
+    }
+
+    g.restoreState();
 }
 
 void PedalComponent::resized()
@@ -159,7 +229,7 @@ void PedalComponent::createControlsForEffect()
         gainSlider->setEnabled(true);
         gainSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(gainSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "gain", *gainSlider));
+        attachSlider(*gainSlider, "gain");
         
         auto* gainLabel = sliderLabels.add(new juce::Label());
         gainLabel->setText("Gain", juce::dontSendNotification);
@@ -177,7 +247,7 @@ void PedalComponent::createControlsForEffect()
         toneSlider->setEnabled(true);
         toneSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(toneSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "tone", *toneSlider));
+        attachSlider(*toneSlider, "tone");
         
         auto* toneLabel = sliderLabels.add(new juce::Label());
         toneLabel->setText("Tone", juce::dontSendNotification);
@@ -195,7 +265,7 @@ void PedalComponent::createControlsForEffect()
         levelSlider->setEnabled(true);
         levelSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(levelSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "level", *levelSlider));
+        attachSlider(*levelSlider, "level");
         
         auto* levelLabel = sliderLabels.add(new juce::Label());
         levelLabel->setText("Level", juce::dontSendNotification);
@@ -215,7 +285,7 @@ void PedalComponent::createControlsForEffect()
         sustainSlider->setEnabled(true);
         sustainSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(sustainSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "sustain", *sustainSlider));
+        attachSlider(*sustainSlider, "sustain");
         
         auto* sustainLabel = sliderLabels.add(new juce::Label());
         sustainLabel->setText("Sustain", juce::dontSendNotification);
@@ -233,7 +303,7 @@ void PedalComponent::createControlsForEffect()
         toneSlider->setEnabled(true);
         toneSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(toneSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "tone", *toneSlider));
+        attachSlider(*toneSlider, "tone");
         
         auto* toneLabel = sliderLabels.add(new juce::Label());
         toneLabel->setText("Tone", juce::dontSendNotification);
@@ -251,7 +321,7 @@ void PedalComponent::createControlsForEffect()
         volumeSlider->setEnabled(true);
         volumeSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(volumeSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "volume", *volumeSlider));
+        attachSlider(*volumeSlider, "volume");
         
         auto* volumeLabel = sliderLabels.add(new juce::Label());
         volumeLabel->setText("Volume", juce::dontSendNotification);
@@ -271,7 +341,7 @@ void PedalComponent::createControlsForEffect()
         gainSlider->setEnabled(true);
         gainSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(gainSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "gain", *gainSlider));
+        attachSlider(*gainSlider, "gain");
         
         auto* gainLabel = sliderLabels.add(new juce::Label());
         gainLabel->setText("Gain", juce::dontSendNotification);
@@ -289,7 +359,7 @@ void PedalComponent::createControlsForEffect()
         toneSlider->setEnabled(true);
         toneSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(toneSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "tone", *toneSlider));
+        attachSlider(*toneSlider, "tone");
         
         auto* toneLabel = sliderLabels.add(new juce::Label());
         toneLabel->setText("Tone", juce::dontSendNotification);
@@ -307,7 +377,7 @@ void PedalComponent::createControlsForEffect()
         levelSlider->setEnabled(true);
         levelSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(levelSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "level", *levelSlider));
+        attachSlider(*levelSlider, "level");
         
         auto* levelLabel = sliderLabels.add(new juce::Label());
         levelLabel->setText("Level", juce::dontSendNotification);
@@ -327,7 +397,7 @@ void PedalComponent::createControlsForEffect()
         threshSlider->setEnabled(true);
         threshSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(threshSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "threshold", *threshSlider));
+        attachSlider(*threshSlider, "threshold");
         
         auto* threshLabel = sliderLabels.add(new juce::Label());
         threshLabel->setText("Thresh", juce::dontSendNotification);
@@ -345,7 +415,7 @@ void PedalComponent::createControlsForEffect()
         ratioSlider->setEnabled(true);
         ratioSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(ratioSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "ratio", *ratioSlider));
+        attachSlider(*ratioSlider, "ratio");
         
         auto* ratioLabel = sliderLabels.add(new juce::Label());
         ratioLabel->setText("Ratio", juce::dontSendNotification);
@@ -363,7 +433,7 @@ void PedalComponent::createControlsForEffect()
         attackSlider->setEnabled(true);
         attackSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(attackSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "attack", *attackSlider));
+        attachSlider(*attackSlider, "attack");
         
         auto* attackLabel = sliderLabels.add(new juce::Label());
         attackLabel->setText("Attack", juce::dontSendNotification);
@@ -381,7 +451,7 @@ void PedalComponent::createControlsForEffect()
         releaseSlider->setEnabled(true);
         releaseSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(releaseSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "release", *releaseSlider));
+        attachSlider(*releaseSlider, "release");
         
         auto* releaseLabel = sliderLabels.add(new juce::Label());
         releaseLabel->setText("Release", juce::dontSendNotification);
@@ -401,7 +471,7 @@ void PedalComponent::createControlsForEffect()
         roomSlider->setEnabled(true);
         roomSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(roomSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "roomSize", *roomSlider));
+        attachSlider(*roomSlider, "roomSize");
         
         auto* roomLabel = sliderLabels.add(new juce::Label());
         roomLabel->setText("Room", juce::dontSendNotification);
@@ -419,7 +489,7 @@ void PedalComponent::createControlsForEffect()
         dampSlider->setEnabled(true);
         dampSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(dampSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "damping", *dampSlider));
+        attachSlider(*dampSlider, "damping");
         
         auto* dampLabel = sliderLabels.add(new juce::Label());
         dampLabel->setText("Damp", juce::dontSendNotification);
@@ -437,7 +507,7 @@ void PedalComponent::createControlsForEffect()
         wetSlider->setEnabled(true);
         wetSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(wetSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "wetLevel", *wetSlider));
+        attachSlider(*wetSlider, "wetLevel");
         
         auto* wetLabel = sliderLabels.add(new juce::Label());
         wetLabel->setText("Mix", juce::dontSendNotification);
@@ -457,7 +527,7 @@ void PedalComponent::createControlsForEffect()
         rateSlider->setEnabled(true);
         rateSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(rateSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "rate", *rateSlider));
+        attachSlider(*rateSlider, "rate");
         
         auto* rateLabel = sliderLabels.add(new juce::Label());
         rateLabel->setText("Rate", juce::dontSendNotification);
@@ -475,7 +545,7 @@ void PedalComponent::createControlsForEffect()
         depthSlider->setEnabled(true);
         depthSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(depthSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "depth", *depthSlider));
+        attachSlider(*depthSlider, "depth");
         
         auto* depthLabel = sliderLabels.add(new juce::Label());
         depthLabel->setText("Depth", juce::dontSendNotification);
@@ -493,7 +563,7 @@ void PedalComponent::createControlsForEffect()
         mixSlider->setEnabled(true);
         mixSlider->setInterceptsMouseClicks(true, true);
         addAndMakeVisible(mixSlider);
-        sliderAttachments.add(new juce::AudioProcessorValueTreeState::SliderAttachment(apvts, paramPrefix + "mix", *mixSlider));
+        attachSlider(*mixSlider, "mix");
         
         auto* mixLabel = sliderLabels.add(new juce::Label());
         mixLabel->setText("Mix", juce::dontSendNotification);
@@ -528,13 +598,39 @@ void PedalComponent::createControlsForEffect()
         addAndMakeVisible(tunerCentsLabel.get());
         
         // Start timer to update tuner display - slower for stability
-        startTimer(100); // Update 10 times per second
+        startTimer(tunerIntervalMs); // Update 10 times per second
     }
     
     // Note: Bypass attachment would need a parameter to be added to the APVTS for each effect
     // For now, we'll handle bypass through the effect's setBypassed method
 }
 
+void PedalComponent::visibilityChanged()
+{
+    updateObserverRegistration();
+}
+
+void PedalComponent::parentHierarchyChanged()
+{
+    updateObserverRegistration();
+}
+
+void PedalComponent::updateObserverRegistration()
+{
+    // Only the tuner display consumes analysis results, and only while it is on screen
+    const bool shouldObserve = effect->getEffectType() == "tuner" && isShowing();
+
+    if (shouldObserve == observingEffect)
+        return;
+
+    if (shouldObserve)
+        effect->addObserver();
+    else
+        effect->removeObserver();
+
+    observingEffect = shouldObserve;
+}
+
 juce::Colour PedalComponent::getPedalColour() const
 {
     // Different colors for different effect types
@@ -562,12 +658,41 @@ void PedalComponent::timerCallback()
     if (effect->getEffectType() == "tuner" && tunerNoteLabel && tunerArrowLabel && tunerCentsLabel)
     {
         auto* tuner = dynamic_cast<Tuner*>(effect);
-        if (tuner && tuner->isNoteDetected())
+        const bool strobeMode = tuner != nullptr && tuner->getMode() == Tuner::Mode::Strobe;
+
+        // The strobe needs a smooth frame rate, the other modes read better slower
+        const int interval = strobeMode ? strobeIntervalMs : tunerIntervalMs;
+        if (getTimerInterval() != interval)
+            startTimer(interval);
+
+        if (strobeMode != showStrobe)
         {
-            tunerNoteLabel->setText(tuner->getNoteName(), juce::dontSendNotification);
+            showStrobe = strobeMode;
+            tunerArrowLabel->setVisible(!showStrobe);
+            repaint();
+        }
+
+        if (strobeMode)
+        {
+            updateStrobeTunerDisplay(*tuner);
+            return;
+        }
+
+        if (tuner != nullptr && tuner->getMode() == Tuner::Mode::Polyphonic)
+        {
+            updatePolyphonicTunerDisplay(*tuner);
+            return;
+        }
+
+        const auto reading = tuner != nullptr ? tuner->getReading() : Tuner::Reading {};
+
+        if (reading.isNoteDetected())
+        {
+            tunerNoteLabel->setText(juce::String(Tuner::getNoteName(reading.noteIndex)) + juce::String(reading.octave),
+                                    juce::dontSendNotification);
             
-            float cents = tuner->getCentsDeviation();
-            int direction = tuner->getTuningDirection();
+            float cents = reading.cents;
+            int direction = reading.getTuningDirection();
             
             // Show arrow for tuning direction
             if (direction > 0)
@@ -608,3 +733,74 @@ void PedalComponent::timerCallback()
         }
     }
 }
+
+void PedalComponent::updateStrobeTunerDisplay(const Tuner& tuner)
+{
+    strobeDisplay = tuner.getStrobeReading();
+
+    if (strobeDisplay.isLocked())
+    {
+        const float cents = strobeDisplay.cents;
+        tunerNoteLabel->setText(juce::String(Tuner::getNoteName(strobeDisplay.noteIndex)) + juce::String(strobeDisplay.octave),
+                                juce::dontSendNotification);
+        tunerCentsLabel->setText(juce::String(cents >= 0.0f ? "+" : "") + juce::String(cents, 1) + "¢",
+                                 juce::dontSendNotification);
+        tunerCentsLabel->setColour(juce::Label::textColourId,
+                                   std::abs(cents) < 1.0f ? juce::Colours::green : juce::Colours::yellow);
+    }
+    else
+    {
+        tunerNoteLabel->setText("--", juce::dontSendNotification);
+        tunerCentsLabel->setText("", juce::dontSendNotification);
+    }
+
+    if (tunerArrowLabel)
+        repaint(tunerArrowLabel->getBounds());
+}
+
+void PedalComponent::updatePolyphonicTunerDisplay(const Tuner& tuner)
+{
+    const auto strings = tuner.getStringReadings();
+    const char* stringNames[Tuner::numStrings] = { "E", "A", "D", "G", "B", "E" };
+
+    // One mark per string, low E first
+    juce::String marks;
+    int numDetected = 0;
+    int numInTune = 0;
+
+    for (int i = 0; i < Tuner::numStrings; ++i)
+    {
+        const auto& string = strings[static_cast<size_t>(i)];
+        const char* mark = "·";
+
+        if (string.detected)
+        {
+            const int direction = string.getTuningDirection();
+            mark = direction > 0 ? "↑" : (direction < 0 ? "↓" : "✓");
+            ++numDetected;
+            numInTune += (direction == 0) ? 1 : 0;
+        }
+
+        marks += juce::String(i > 0 ? " " : "") + stringNames[i] + mark;
+    }
+
+    tunerNoteLabel->setText("POLY", juce::dontSendNotification);
+    tunerCentsLabel->setText(marks, juce::dontSendNotification);
+    tunerCentsLabel->setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+
+    if (numDetected == 0)
+    {
+        tunerArrowLabel->setText("♪ Strum all strings", juce::dontSendNotification);
+        tunerArrowLabel->setColour(juce::Label::textColourId, juce::Colours::grey);
+    }
+    else if (numInTune == numDetected)
+    {
+        tunerArrowLabel->setText("★ IN TUNE ★", juce::dontSendNotification);
+        tunerArrowLabel->setColour(juce::Label::textColourId, juce::Colours::green);
+    }
+    else
+    {
+        tunerArrowLabel->setText(juce::String(numDetected - numInTune) + " OUT", juce::dontSendNotification);
+        tunerArrowLabel->setColour(juce::Label::textColourId, juce::Colours::orange);
+    }
+}
@@ -4,6 +4,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "../EffectFactory.h"
 #include "../../effects/EffectBase.h"
+#include "../../effects/Tuner.h"
 
 /**
  * Visual component representing a single guitar effect pedal.
@@ -17,7 +18,7 @@ public:
      * Creates a pedal component for a specific effect.
      * @param effect The effect to visualize
      * @param apvts The parameter tree for parameter attachments
-     * @param prefix The parameter prefix for this effect (e.g., "effect0_")
+     * @param prefix The parameter prefix for this effect (e.g., "slot0_")
      * @param index The position of this effect in the chain
      */
     PedalComponent(EffectBase* effect,
@@ -30,6 +31,8 @@ public:
     //==============================================================================
     void paint(juce::Graphics& g) override;
     void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
     
     //==============================================================================
     /**
@@ -53,6 +56,7 @@ private:
     juce::String paramPrefix;
     int effectIndex;
     bool beingDragged = false;
+    bool observingEffect = false;   // Registered with EffectBase::addObserver()
     
     // UI Components
     juce::Label nameLabel;
@@ -69,10 +73,27 @@ private:
     std::unique_ptr<juce::Label> tunerCentsLabel;
     std::unique_ptr<juce::Label> tunerArrowLabel;
     
+    // Strobe display, drawn in place of the arrow label in strobe mode
+    bool showStrobe = false;
+    Tuner::StrobeReading strobeDisplay;
+    static constexpr int tunerIntervalMs = 100;
+    static constexpr int strobeIntervalMs = 33;
+
     //==============================================================================
     void createControlsForEffect();
+
+    /** Maps one of the effect's ParameterInfo ids to the slot parameter behind it. */
+    juce::String getParameterID(const juce::String& effectParameterID) const;
+
+    /** Attaches a slider to the slot parameter behind one of the effect's ParameterInfo ids. */
+    void attachSlider(juce::Slider& slider, const juce::String& effectParameterID);
+
     juce::Colour getPedalColour() const;
+    void updateObserverRegistration();
     void timerCallback();
+    void updatePolyphonicTunerDisplay(const Tuner& tuner);
+    void updateStrobeTunerDisplay(const Tuner& tuner);
+    void paintStrobe(juce::Graphics& g, juce::Rectangle<float> area) const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PedalComponent)
 };
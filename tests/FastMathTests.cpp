@@ -0,0 +1,93 @@
+#include <juce_core/juce_core.h>
+#include "../src/dsp/FastMath.h"
+#include <cmath>
+#include <limits>
+
+/**
+ * Sweeps every FastMath kernel against double precision libm and checks the
+ * error bounds documented in FastMath.h.
+ */
+class FastMathTests : public juce::UnitTest
+{
+public:
+    FastMathTests() : juce::UnitTest("FastMath", "OpenGuitar") {}
+
+    void runTest() override
+    {
+        beginTest("exp2");
+        expectWithinBound(-126.0, 126.0, [](float x) { return FastMath::exp2(x); },
+                          [](double x) { return std::exp2(x); },
+                          [](double, double reference) { return 2.5e-7 * reference; });
+
+        beginTest("exp");
+        expectWithinBound(-87.0, 87.0, [](float x) { return FastMath::exp(x); },
+                          [](double x) { return std::exp(x); },
+                          [](double x, double reference) { return 2.5e-7 * std::max(1.0, std::abs(x)) * reference; });
+
+        // Logarithms: every binade of the normal floats, swept through the exponent
+        beginTest("log2");
+        expectWithinBound(-126.0, 127.99, [](float e) { return FastMath::log2(std::exp2(e)); },
+                          [](double e) { return std::log2(static_cast<double>(std::exp2(static_cast<float>(e)))); },
+                          [](double, double reference) { return 1.7e-7 * std::max(1.0, std::abs(reference)); });
+
+        beginTest("log");
+        expectWithinBound(-126.0, 127.99, [](float e) { return FastMath::log(std::exp2(e)); },
+                          [](double e) { return std::log(static_cast<double>(std::exp2(static_cast<float>(e)))); },
+                          [](double, double reference) { return 1.7e-7 * std::max(1.0, std::abs(reference)); });
+
+        beginTest("tanh");
+        expectWithinBound(-20.0, 20.0, [](float x) { return FastMath::tanh(x); },
+                          [](double x) { return std::tanh(x); },
+                          [](double, double) { return 1.5e-7; });
+
+        expectEquals(FastMath::tanh(std::numeric_limits<float>::max()), 1.0f);
+        expectEquals(FastMath::tanh(-std::numeric_limits<float>::max()), -1.0f);
+
+        beginTest("decibelsToGain");
+        expectWithinBound(-120.0, 40.0, [](float dB) { return FastMath::decibelsToGain(dB); },
+                          [](double dB) { return std::pow(10.0, dB / 20.0); },
+                          [](double dB, double reference) { return 2.7e-7 * std::max(1.0, std::abs(dB) / 10.0) * reference; });
+
+        // Gains from the -100 dB floor to +40 dB, swept in dB so every decade gets the same density
+        beginTest("gainToDecibels");
+        expectWithinBound(-99.9, 40.0, [](float dB) { return FastMath::gainToDecibels(std::pow(10.0f, dB / 20.0f)); },
+                          [](double dB) { return 20.0 * std::log10(static_cast<double>(std::pow(10.0f, static_cast<float>(dB) / 20.0f))); },
+                          [](double, double reference) { return 3.0e-7 * std::max(1.0, std::abs(reference)); });
+
+        expectEquals(FastMath::gainToDecibels(0.0f), -100.0f);
+        expectEquals(FastMath::gainToDecibels(1.0e-9f, -80.0f), -80.0f);
+    }
+
+private:
+    static constexpr int sweepPoints = 1 << 20;
+
+    /**
+     * Evaluates kernel and reference at sweepPoints evenly spaced float inputs
+     * and expects every error to stay within the allowance at that point.
+     */
+    template <typename Kernel, typename Reference, typename Allowance>
+    void expectWithinBound(double start, double end, Kernel kernel, Reference reference, Allowance allowance)
+    {
+        double worstRatio = 0.0;
+        double worstInput = start;
+
+        for (int i = 0; i <= sweepPoints; ++i)
+        {
+            // Round the input to float first, so libm sees exactly what the kernel sees
+            const float input = static_cast<float>(start + (end - start) * i / sweepPoints);
+            const double expected = reference(static_cast<double>(input));
+            const double error = std::abs(static_cast<double>(kernel(input)) - expected);
+            const double ratio = error / allowance(static_cast<double>(input), std::abs(expected));
+
+            if (ratio > worstRatio)
+            {
+                worstRatio = ratio;
+                worstInput = input;
+            }
+        }
+
+        expectLessOrEqual(worstRatio, 1.0, "worst error at " + juce::String(worstInput) + " exceeds the documented bound");
+    }
+};
+
+static FastMathTests fastMathTests;
@@ -0,0 +1,19 @@
+#include <juce_core/juce_core.h>
+
+/**
+ * Runs every unit test in the OpenGuitar category and exits non-zero on failure,
+ * so CTest can run it.
+ */
+int main()
+{
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("OpenGuitar");
+
+    int failures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}